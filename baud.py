@@ -0,0 +1,43 @@
+import time
+
+import serial
+
+
+def send(port: serial.Serial, line: str) -> None:
+    checksum = 0
+    for c in line:
+        checksum ^= ord(c)
+    port.write(f'{line}@{checksum:02x}\n'.encode())
+
+
+def wait_for_line(port: serial.Serial, expected: str, timeout: float) -> bool:
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        line = port.read_until(b'\n').decode(errors='replace').strip()
+        if line[-3:-2] == '@':
+            line = line[:-3]
+        if line == expected:
+            return True
+    return False
+
+
+def switch_baud_rate(port: serial.Serial, baud_rate: int, timeout: float = 1.0) -> None:
+    """Switch the microcontroller and the serial port to a new baud rate using `core.baud()`.
+
+    If the microcontroller does not respond, the port keeps its previous baud rate and an exception is raised.
+    Without confirmation the microcontroller falls back to its default baud rate after 2 seconds.
+    """
+    previous_baud_rate = port.baudrate
+    port.reset_input_buffer()
+    send(port, f'core.baud({baud_rate})')
+    if not wait_for_line(port, f'baud {baud_rate}', timeout):
+        raise TimeoutError(f'Microcontroller did not announce baud rate {baud_rate}')
+    time.sleep(0.01)
+    port.baudrate = baud_rate
+    port.reset_input_buffer()
+    port.write(b'\n')
+    send(port, 'core.confirm_baud()')
+    if not wait_for_line(port, f'baud {baud_rate} confirmed', timeout):
+        port.baudrate = previous_baud_rate
+        raise TimeoutError(f'Baud rate {baud_rate} was not confirmed')
+    print(f'Switched to {baud_rate} baud')
@@ -5,11 +5,14 @@ from pathlib import Path
 
 import serial
 
-if len(sys.argv) != 3:
-    print(f'Usage: {sys.argv[0]} <config_file> <device_path>')
+from baud import switch_baud_rate
+
+if len(sys.argv) not in [3, 5] or (len(sys.argv) == 5 and sys.argv[3] != '--baud'):
+    print(f'Usage: {sys.argv[0]} <config_file> <device_path> [--baud <baud_rate>]')
     exit()
 
-txt_path, usb_path = sys.argv[1:]
+txt_path, usb_path = sys.argv[1:3]
+baud_rate = int(sys.argv[4]) if len(sys.argv) == 5 else None
 
 
 def send(line) -> None:
@@ -21,6 +24,9 @@ def send(line) -> None:
 
 
 with serial.Serial(usb_path, baudrate=115200, timeout=1.0) as port:
+    if baud_rate:
+        switch_baud_rate(port, baud_rate)
+
     startup = Path(txt_path).read_text()
     if not startup.endswith('\n'):
         startup += '\n'
@@ -31,6 +37,7 @@ with serial.Serial(usb_path, baudrate=115200, timeout=1.0) as port:
         send(f'!+{line}')
     send('!.')
     send('core.restart()')
+    port.baudrate = 115200  # the microcontroller restarts with its default baud rate
 
     time.sleep(3.0)
     send('core.startup_checksum()')
@@ -1,6 +1,7 @@
 #!/usr/bin/env python3
 import json
 import os.path
+import struct
 from functools import reduce
 from operator import ixor
 
@@ -16,6 +17,61 @@ def send(line):
     port.write(line.encode())
 
 
+def crc16(data):
+    crc = 0xffff
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021 if crc & 0x8000 else crc << 1) & 0xffff
+    return crc
+
+
+def cobs_decode(data):
+    output = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        output.extend(data[i + 1:i + code])
+        i += code
+        if code < 0xff and i < len(data):
+            output.append(0)
+    return bytes(output)
+
+
+class DeltaDecoder:
+    '''Decodes delta frames of `core.output_binary()` (see `telemetry.py` in the Lizard repository).'''
+
+    def __init__(self):
+        self.schema_id = None
+        self.formats = []
+        self.values = None
+        self.sequence = 0
+
+    def parse_schema(self, words):
+        self.schema_id = int(words[1])
+        self.formats = [word.rsplit(':', 1)[1] for word in words[3:]]
+        self.values = None
+
+    def decode(self, frame):
+        payload = cobs_decode(frame)
+        if len(payload) < 4 or crc16(payload[:-2]) != struct.unpack('<H', payload[-2:])[0] or payload[0] != self.schema_id:
+            return None
+        bitmask_size = (len(self.formats) + 7) // 8
+        bitmask = payload[2:2 + bitmask_size]
+        included = [i for i in range(len(self.formats)) if bitmask[i // 8] & (1 << (i % 8))]
+        format_ = '<' + ''.join(self.formats[i] for i in included)
+        if len(payload) - 4 - bitmask_size != struct.calcsize(format_):
+            return None
+        if len(included) < len(self.formats) and (self.values is None or payload[1] != (self.sequence + 1) % 256):
+            self.values = None  # wait for the next keyframe
+            return None
+        self.values = self.values or [None] * len(self.formats)
+        for i, value in zip(included, struct.unpack(format_, payload[2 + bitmask_size:-2])):
+            self.values[i] = value
+        self.sequence = payload[1]
+        return self.values
+
+
 def handle_command(data):
     send(f'wheels.speed({data.linear.x:3f}, {data.angular.z:.3f})')
 
@@ -37,10 +93,32 @@ if __name__ == '__main__':
     rospy.Subscriber('/steer', Twist, handle_command, queue_size=1)
     rospy.Subscriber('/configure', Empty, handle_configure, queue_size=1)
 
+    decoder = DeltaDecoder()
     with serial.Serial('/dev/esp', 115200) as port:
+        # changed values are sent every cycle, all values every 50 cycles
+        send('core.output_binary("core.millis wheels.linear_speed:0.001 wheels.angular_speed:0.001", 50)')
         while not rospy.is_shutdown():
+            # binary frames are enclosed in zero bytes, everything else is a text line
+            first_byte = port.read(1)
+            if first_byte == b'\x00':
+                frame = port.read_until(b'\x00')[:-1]
+                if not frame:
+                    continue
+                values = decoder.decode(frame)
+                if values is None:
+                    continue
+                time, linear_speed, angular_speed = values
+                publish_odometry(Twist(
+                    Vector3(linear_speed, 0, 0),
+                    Vector3(0, 0, angular_speed),
+                ))
+                publish_status(json.dumps({
+                    'time': time,
+                }))
+                continue
+
             try:
-                line = port.readline().decode().strip()
+                line = (first_byte + port.readline()).decode().strip()
             except UnicodeDecodeError:
                 continue
             if line[-3:-2] == '@':
@@ -49,18 +127,5 @@ if __name__ == '__main__':
                     continue
 
             words = line.split()
-            if not any(words):
-                continue
-            if words.pop(0) != '!"core':
-                continue
-            time = int(words.pop(0))
-            linear_speed = float(words.pop(0))
-            angular_speed = float(words.pop(0))
-
-            publish_odometry(Twist(
-                Vector3(linear_speed, 0, 0),
-                Vector3(0, 0, angular_speed),
-            ))
-            publish_status(json.dumps({
-                'time': time,
-            }))
+            if len(words) > 2 and words[0] == 'schema' and words[2] == 'delta':
+                decoder.parse_schema(words)
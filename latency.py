@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+import argparse
+import random
+import time
+from typing import List
+
+import serial
+
+from baud import send, switch_baud_rate
+
+parser = argparse.ArgumentParser(description='Lizard command latency')
+parser.add_argument('device_path', help='serial device')
+parser.add_argument('--count', type=int, default=1000, help='number of commands (default: 1000)')
+parser.add_argument('--baud', type=int, help='switch to this baud rate after connecting')
+args = parser.parse_args()
+
+
+def percentile(values: List[float], fraction: float) -> float:
+    return values[min(int(fraction * len(values)), len(values) - 1)]
+
+
+def wait_for_reply(port: serial.Serial, expected: str, timeout: float) -> bool:
+    deadline = time.perf_counter() + timeout
+    while time.perf_counter() < deadline:
+        line = port.read_until(b'\n').decode(errors='replace').strip()
+        if line[-3:-2] == '@':
+            line = line[:-3]
+        if line == expected:
+            return True
+    return False
+
+
+with serial.Serial(args.device_path, baudrate=115200, timeout=0.1) as port:
+    if args.baud:
+        switch_baud_rate(port, args.baud)
+    port.reset_input_buffer()
+
+    latencies: List[float] = []
+    lost = 0
+    for i in range(args.count):
+        time.sleep(random.uniform(0.0, 0.02))
+        start = time.perf_counter()
+        send(port, f'core.print("latency", {i})')
+        if wait_for_reply(port, f'"latency" {i}', 1.0):
+            latencies.append(time.perf_counter() - start)
+        else:
+            lost += 1
+
+    if not latencies:
+        raise TimeoutError('No replies received')
+    latencies.sort()
+    transfer = (len(f'core.print("latency", {args.count})@00\n') + len(f'"latency" {args.count}@00\r\n')) * 10 / port.baudrate
+    print(f'{len(latencies)} replies, {lost} lost')
+    print(f'p50: {percentile(latencies, 0.5) * 1000:.2f} ms')
+    print(f'p90: {percentile(latencies, 0.9) * 1000:.2f} ms')
+    print(f'p99: {percentile(latencies, 0.99) * 1000:.2f} ms')
+    print(f'max: {latencies[-1] * 1000:.2f} ms')
+    print(f'including about {transfer * 1000:.2f} ms for transferring the command and its reply')
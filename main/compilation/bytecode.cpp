@@ -0,0 +1,362 @@
+#include "bytecode.h"
+#include <cmath>
+#include <stdexcept>
+
+void Bytecode::append(const Instruction instruction, const int stack_effect) {
+    this->instructions.push_back(instruction);
+    this->depth += stack_effect;
+    if (this->depth > this->max_depth) {
+        this->max_depth = this->depth;
+    }
+}
+
+void Bytecode::emit(const Opcode opcode, const int stack_effect) {
+    Instruction instruction;
+    instruction.opcode = opcode;
+    instruction.integer_value = 0;
+    this->append(instruction, stack_effect);
+}
+
+void Bytecode::emit_boolean(const bool value) {
+    Instruction instruction;
+    instruction.opcode = Opcode::push_boolean;
+    instruction.integer_value = 0;
+    instruction.boolean_value = value;
+    this->append(instruction, 1);
+}
+
+void Bytecode::emit_integer(const int64_t value) {
+    Instruction instruction;
+    instruction.opcode = Opcode::push_integer;
+    instruction.integer_value = value;
+    this->append(instruction, 1);
+}
+
+void Bytecode::emit_number(const number_t value) {
+    Instruction instruction;
+    instruction.opcode = Opcode::push_number;
+    instruction.number_value = value;
+    this->append(instruction, 1);
+}
+
+void Bytecode::emit_variable(const Opcode opcode, const ConstVariable_ptr variable) {
+    Instruction instruction;
+    instruction.opcode = opcode;
+    instruction.variable = variable.get();
+    this->variables.push_back(variable);
+    this->append(instruction, 1);
+}
+
+size_t Bytecode::emit_jump(const Opcode opcode) {
+    this->emit(opcode, -1);
+    return this->instructions.size() - 1;
+}
+
+void Bytecode::patch_jump(const size_t index) {
+    this->instructions[index].target = this->instructions.size();
+}
+
+void Bytecode::emit_expression(const ConstExpression_ptr expression, const Type type) {
+    // the tree evaluator throws lazily, so compilation errors are deferred to run time
+    const size_t size = this->instructions.size();
+    const unsigned int depth = this->depth;
+    try {
+        expression->emit(*this, type);
+    } catch (const std::runtime_error &e) {
+        this->instructions.resize(size);
+        this->depth = depth;
+        this->messages.push_back(e.what());
+        Instruction instruction;
+        instruction.opcode = Opcode::fail;
+        instruction.message = this->messages.size() - 1;
+        this->append(instruction, 1);
+    }
+}
+
+void Bytecode::emit_binary(const ConstExpression_ptr left, const ConstExpression_ptr right, const Type type, const Opcode opcode) {
+    this->emit_expression(left, type);
+    this->emit_expression(right, type);
+    this->emit(opcode, -1);
+}
+
+size_t Bytecode::compile(const ConstExpression_ptr expression, const Type type) {
+    const size_t entry = this->instructions.size();
+    this->depth = 0;
+    this->emit_expression(expression, type);
+    this->emit(Opcode::end, 0);
+    return entry;
+}
+
+size_t Bytecode::size() const {
+    return this->instructions.size();
+}
+
+unsigned int Bytecode::get_max_depth() const {
+    return this->max_depth;
+}
+
+void Bytecode::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    variables.insert(variables.end(), this->variables.begin(), this->variables.end());
+}
+
+Value Bytecode::run(const size_t entry) const {
+    // threaded dispatch (GCC labels as values) with one indirect jump per handler
+    static const void *const handlers[] = {
+        &&op_push_boolean,
+        &&op_push_integer,
+        &&op_push_number,
+        &&op_load_boolean,
+        &&op_load_integer,
+        &&op_load_number,
+        &&op_boolean_to_integer,
+        &&op_integer_to_number,
+        &&op_power_integer,
+        &&op_power_number,
+        &&op_negate_integer,
+        &&op_negate_number,
+        &&op_multiply_integer,
+        &&op_multiply_number,
+        &&op_divide_integer,
+        &&op_divide_number,
+        &&op_modulo_integer,
+        &&op_modulo_number,
+        &&op_floor_divide_integer,
+        &&op_floor_divide_number,
+        &&op_add_integer,
+        &&op_add_number,
+        &&op_subtract_integer,
+        &&op_subtract_number,
+        &&op_shift_left,
+        &&op_shift_right,
+        &&op_bit_and,
+        &&op_bit_xor,
+        &&op_bit_or,
+        &&op_greater,
+        &&op_less,
+        &&op_greater_equal,
+        &&op_less_equal,
+        &&op_equal,
+        &&op_unequal,
+        &&op_logical_not,
+        &&op_jump_if_false_or_pop,
+        &&op_jump_if_true_or_pop,
+        &&op_fail,
+        &&op_end,
+    };
+    static_assert(sizeof(handlers) / sizeof(handlers[0]) == static_cast<size_t>(Opcode::end) + 1, "handler table does not match Opcode");
+    Value stack[BYTECODE_STACK_SIZE];
+    Value *top = stack - 1;
+    const Instruction *const instructions = this->instructions.data();
+    const Instruction *instruction = &instructions[entry];
+
+#define DISPATCH() goto *handlers[static_cast<uint8_t>(instruction->opcode)]
+#define NEXT() \
+    ++instruction; \
+    DISPATCH()
+
+    DISPATCH();
+op_push_boolean:
+    (++top)->boolean_value = instruction->boolean_value;
+    NEXT();
+op_push_integer:
+    (++top)->integer_value = instruction->integer_value;
+    NEXT();
+op_push_number:
+    (++top)->number_value = instruction->number_value;
+    NEXT();
+op_load_boolean:
+    (++top)->boolean_value = instruction->variable->boolean_value;
+    NEXT();
+op_load_integer:
+    (++top)->integer_value = instruction->variable->integer_value;
+    NEXT();
+op_load_number:
+    (++top)->number_value = instruction->variable->number_value;
+    NEXT();
+op_boolean_to_integer:
+    top->integer_value = top->boolean_value ? 1 : 0;
+    NEXT();
+op_integer_to_number:
+    top->number_value = top->integer_value;
+    NEXT();
+op_power_integer:
+    --top;
+    top->integer_value = std::pow(top[0].integer_value, top[1].integer_value);
+    NEXT();
+op_power_number:
+    --top;
+    top->number_value = std::pow(top[0].number_value, top[1].number_value);
+    NEXT();
+op_negate_integer:
+    top->integer_value = -top->integer_value;
+    NEXT();
+op_negate_number:
+    top->number_value = -top->number_value;
+    NEXT();
+op_multiply_integer:
+    --top;
+    top->integer_value = top[0].integer_value * top[1].integer_value;
+    NEXT();
+op_multiply_number:
+    --top;
+    top->number_value = top[0].number_value * top[1].number_value;
+    NEXT();
+op_divide_integer:
+op_floor_divide_integer:
+    --top;
+    top->integer_value = top[0].integer_value / top[1].integer_value;
+    NEXT();
+op_divide_number:
+    --top;
+    top->number_value = top[0].number_value / top[1].number_value;
+    NEXT();
+op_modulo_integer:
+    --top;
+    top->integer_value = top[0].integer_value % top[1].integer_value;
+    NEXT();
+op_modulo_number:
+    --top;
+    top->number_value = std::fmod(top[0].number_value, top[1].number_value);
+    NEXT();
+op_floor_divide_number:
+    --top;
+    top->number_value = std::floor(top[0].number_value / top[1].number_value);
+    NEXT();
+op_add_integer:
+    --top;
+    top->integer_value = top[0].integer_value + top[1].integer_value;
+    NEXT();
+op_add_number:
+    --top;
+    top->number_value = top[0].number_value + top[1].number_value;
+    NEXT();
+op_subtract_integer:
+    --top;
+    top->integer_value = top[0].integer_value - top[1].integer_value;
+    NEXT();
+op_subtract_number:
+    --top;
+    top->number_value = top[0].number_value - top[1].number_value;
+    NEXT();
+op_shift_left:
+    --top;
+    top->integer_value = top[0].integer_value << top[1].integer_value;
+    NEXT();
+op_shift_right:
+    --top;
+    top->integer_value = top[0].integer_value >> top[1].integer_value;
+    NEXT();
+op_bit_and:
+    --top;
+    top->integer_value = top[0].integer_value & top[1].integer_value;
+    NEXT();
+op_bit_xor:
+    --top;
+    top->integer_value = top[0].integer_value ^ top[1].integer_value;
+    NEXT();
+op_bit_or:
+    --top;
+    top->integer_value = top[0].integer_value | top[1].integer_value;
+    NEXT();
+op_greater:
+    --top;
+    top->boolean_value = top[0].number_value > top[1].number_value;
+    NEXT();
+op_less:
+    --top;
+    top->boolean_value = top[0].number_value < top[1].number_value;
+    NEXT();
+op_greater_equal:
+    --top;
+    top->boolean_value = top[0].number_value >= top[1].number_value;
+    NEXT();
+op_less_equal:
+    --top;
+    top->boolean_value = top[0].number_value <= top[1].number_value;
+    NEXT();
+op_equal:
+    --top;
+    top->boolean_value = top[0].number_value == top[1].number_value;
+    NEXT();
+op_unequal:
+    --top;
+    top->boolean_value = top[0].number_value != top[1].number_value;
+    NEXT();
+op_logical_not:
+    top->boolean_value = !top->boolean_value;
+    NEXT();
+op_jump_if_false_or_pop:
+    if (!top->boolean_value) {
+        instruction = &instructions[instruction->target];
+        DISPATCH();
+    }
+    --top;
+    NEXT();
+op_jump_if_true_or_pop:
+    if (top->boolean_value) {
+        instruction = &instructions[instruction->target];
+        DISPATCH();
+    }
+    --top;
+    NEXT();
+op_fail:
+    throw std::runtime_error(this->messages[instruction->message]);
+op_end:
+    return *top;
+
+#undef NEXT
+#undef DISPATCH
+}
+
+BytecodeExpression::BytecodeExpression(const ConstExpression_ptr expression)
+    : Expression(expression->type) {
+    if (this->type == boolean) {
+        this->boolean_entry = this->bytecode.compile(expression, boolean);
+    }
+    if (this->type == integer) {
+        this->integer_entry = this->bytecode.compile(expression, integer);
+    }
+    if (this->type == integer || this->type == number) {
+        this->number_entry = this->bytecode.compile(expression, number);
+    }
+}
+
+ConstExpression_ptr BytecodeExpression::create(const ConstExpression_ptr expression) {
+    if (!expression->is_numbery()) {
+        return expression;
+    }
+    const std::shared_ptr<BytecodeExpression> bytecode_expression = std::make_shared<BytecodeExpression>(expression);
+    if (bytecode_expression->bytecode.get_max_depth() > BYTECODE_STACK_SIZE) {
+        return expression;
+    }
+    const size_t primary_size = expression->type == integer ? bytecode_expression->number_entry : bytecode_expression->bytecode.size();
+    if (primary_size <= 2) {
+        return expression;
+    }
+    return bytecode_expression;
+}
+
+bool BytecodeExpression::evaluate_boolean() const {
+    if (this->boolean_entry == SIZE_MAX) {
+        return Expression::evaluate_boolean();
+    }
+    return this->bytecode.run(this->boolean_entry).boolean_value;
+}
+
+int64_t BytecodeExpression::evaluate_integer() const {
+    if (this->integer_entry == SIZE_MAX) {
+        return Expression::evaluate_integer();
+    }
+    return this->bytecode.run(this->integer_entry).integer_value;
+}
+
+number_t BytecodeExpression::evaluate_number() const {
+    if (this->number_entry == SIZE_MAX) {
+        return Expression::evaluate_number();
+    }
+    return this->bytecode.run(this->number_entry).number_value;
+}
+
+void BytecodeExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->bytecode.collect_variables(variables);
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "expression.h"
+#include "type.h"
+#include "variable.h"
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define BYTECODE_STACK_SIZE 32
+
+enum class Opcode : uint8_t {
+    push_boolean,
+    push_integer,
+    push_number,
+    load_boolean,
+    load_integer,
+    load_number,
+    boolean_to_integer,
+    integer_to_number,
+    power_integer,
+    power_number,
+    negate_integer,
+    negate_number,
+    multiply_integer,
+    multiply_number,
+    divide_integer,
+    divide_number,
+    modulo_integer,
+    modulo_number,
+    floor_divide_integer,
+    floor_divide_number,
+    add_integer,
+    add_number,
+    subtract_integer,
+    subtract_number,
+    shift_left,
+    shift_right,
+    bit_and,
+    bit_xor,
+    bit_or,
+    greater,
+    less,
+    greater_equal,
+    less_equal,
+    equal,
+    unequal,
+    logical_not,
+    jump_if_false_or_pop,
+    jump_if_true_or_pop,
+    fail,
+    end,
+};
+
+struct Instruction {
+    Opcode opcode;
+    union {
+        bool boolean_value;
+        int64_t integer_value;
+        number_t number_value;
+        const Variable *variable;
+        uint32_t target;
+        uint32_t message;
+    };
+};
+
+union Value {
+    bool boolean_value;
+    int64_t integer_value;
+    number_t number_value;
+};
+
+class Bytecode {
+private:
+    std::vector<Instruction> instructions;
+    std::vector<ConstVariable_ptr> variables;
+    std::vector<std::string> messages;
+    unsigned int depth = 0;
+    unsigned int max_depth = 0;
+
+    void append(const Instruction instruction, const int stack_effect);
+
+public:
+    void emit(const Opcode opcode, const int stack_effect);
+    void emit_boolean(const bool value);
+    void emit_integer(const int64_t value);
+    void emit_number(const number_t value);
+    void emit_variable(const Opcode opcode, const ConstVariable_ptr variable);
+    size_t emit_jump(const Opcode opcode);
+    void patch_jump(const size_t index);
+    void emit_expression(const ConstExpression_ptr expression, const Type type);
+    void emit_binary(const ConstExpression_ptr left, const ConstExpression_ptr right, const Type type, const Opcode opcode);
+    size_t compile(const ConstExpression_ptr expression, const Type type);
+    size_t size() const;
+    unsigned int get_max_depth() const;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const;
+    Value run(const size_t entry) const;
+};
+
+class BytecodeExpression : public Expression {
+private:
+    Bytecode bytecode;
+    size_t boolean_entry = SIZE_MAX;
+    size_t integer_entry = SIZE_MAX;
+    size_t number_entry = SIZE_MAX;
+
+public:
+    BytecodeExpression(const ConstExpression_ptr expression);
+    static ConstExpression_ptr create(const ConstExpression_ptr expression);
+    bool evaluate_boolean() const override;
+    int64_t evaluate_integer() const override;
+    number_t evaluate_number() const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
+};
@@ -1,5 +1,7 @@
 #include "expression.h"
-#include "math.h"
+#include "../utils/format.h"
+#include "bytecode.h"
+#include <cmath>
 #include <stdexcept>
 
 int write_arguments_to_buffer(const std::vector<ConstExpression_ptr> arguments, char *buffer) {
@@ -46,7 +48,7 @@ int64_t Expression::evaluate_integer() const {
     return evaluate_boolean() ? 1 : 0;
 }
 
-double Expression::evaluate_number() const {
+number_t Expression::evaluate_number() const {
     return evaluate_integer();
 }
 
@@ -58,6 +60,32 @@ std::string Expression::evaluate_string() const {
     throw std::runtime_error("not implemented");
 }
 
+void Expression::emit(Bytecode &bytecode, const Type type) const {
+    switch (type) {
+    case integer:
+        this->emit(bytecode, boolean);
+        bytecode.emit(Opcode::boolean_to_integer, 0);
+        break;
+    case number:
+        this->emit(bytecode, integer);
+        bytecode.emit(Opcode::integer_to_number, 0);
+        break;
+    default:
+        throw std::runtime_error("not implemented");
+    }
+}
+
+bool Expression::is_constant() const {
+    return false;
+}
+
+ConstExpression_ptr Expression::get_negated_operand() const {
+    return nullptr;
+}
+
+void Expression::collect_variables(std::vector<ConstVariable_ptr> &) const {
+}
+
 bool Expression::is_numbery() const {
     return this->type == number || this->type == integer || this->type == boolean;
 }
@@ -67,9 +95,9 @@ int Expression::print_to_buffer(char *buffer) const {
     case boolean:
         return sprintf(buffer, "%s", this->evaluate_boolean() ? "true" : "false");
     case integer:
-        return sprintf(buffer, "%lld", this->evaluate_integer());
+        return format_integer(buffer, this->evaluate_integer());
     case number:
-        return sprintf(buffer, "%f", this->evaluate_number());
+        return format_number(buffer, this->evaluate_number(), 6);
     case string:
         return sprintf(buffer, "\"%s\"", this->evaluate_string().c_str());
     case identifier:
@@ -87,6 +115,18 @@ bool BooleanExpression::evaluate_boolean() const {
     return this->value;
 }
 
+void BooleanExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == boolean) {
+        bytecode.emit_boolean(this->value);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+bool BooleanExpression::is_constant() const {
+    return true;
+}
+
 StringExpression::StringExpression(std::string value)
     : Expression(string), value(value) {
 }
@@ -95,6 +135,10 @@ std::string StringExpression::evaluate_string() const {
     return this->value;
 }
 
+bool StringExpression::is_constant() const {
+    return true;
+}
+
 IntegerExpression::IntegerExpression(int64_t value)
     : Expression(integer), value(value) {
 }
@@ -103,18 +147,44 @@ int64_t IntegerExpression::evaluate_integer() const {
     return this->value;
 }
 
-double IntegerExpression::evaluate_number() const {
+number_t IntegerExpression::evaluate_number() const {
     return this->value;
 }
 
-NumberExpression::NumberExpression(double value)
+void IntegerExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == integer) {
+        bytecode.emit_integer(this->value);
+    } else if (type == number) {
+        bytecode.emit_number(this->value);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+bool IntegerExpression::is_constant() const {
+    return true;
+}
+
+NumberExpression::NumberExpression(number_t value)
     : Expression(number), value(value) {
 }
 
-double NumberExpression::evaluate_number() const {
+number_t NumberExpression::evaluate_number() const {
     return this->value;
 }
 
+void NumberExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == number) {
+        bytecode.emit_number(this->value);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+bool NumberExpression::is_constant() const {
+    return true;
+}
+
 VariableExpression::VariableExpression(const ConstVariable_ptr variable)
     : Expression(variable->type), variable(variable) {
 }
@@ -133,25 +203,59 @@ int64_t VariableExpression::evaluate_integer() const {
     return this->variable->integer_value;
 }
 
-double VariableExpression::evaluate_number() const {
+number_t VariableExpression::evaluate_number() const {
     if (!this->is_numbery()) {
         throw std::runtime_error("variable is not a number");
     }
     return this->type == number ? this->variable->number_value : this->variable->integer_value;
 }
 
+void VariableExpression::emit(Bytecode &bytecode, const Type type) const {
+    switch (type) {
+    case boolean:
+        if (this->type != boolean) {
+            throw std::runtime_error("variable is not a boolean");
+        }
+        bytecode.emit_variable(Opcode::load_boolean, this->variable);
+        break;
+    case integer:
+        if (this->type != integer) {
+            throw std::runtime_error("variable is not an integer");
+        }
+        bytecode.emit_variable(Opcode::load_integer, this->variable);
+        break;
+    case number:
+        if (!this->is_numbery()) {
+            throw std::runtime_error("variable is not a number");
+        }
+        if (this->type == number) {
+            bytecode.emit_variable(Opcode::load_number, this->variable);
+        } else {
+            bytecode.emit_variable(Opcode::load_integer, this->variable);
+            bytecode.emit(Opcode::integer_to_number, 0);
+        }
+        break;
+    default:
+        Expression::emit(bytecode, type);
+    }
+}
+
 std::string VariableExpression::evaluate_string() const {
     if (this->type != string) {
         throw std::runtime_error("variable is not a string");
     }
-    return this->variable->string_value;
+    return *this->variable->string_value;
 }
 
 std::string VariableExpression::evaluate_identifier() const {
     if (this->type != identifier) {
         throw std::runtime_error("variable is not an identifier");
     }
-    return this->variable->identifier_value;
+    return *this->variable->string_value;
+}
+
+void VariableExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    variables.push_back(this->variable);
 }
 
 PowerExpression::PowerExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
@@ -159,11 +263,26 @@ PowerExpression::PowerExpression(const ConstExpression_ptr left, const ConstExpr
 }
 
 int64_t PowerExpression::evaluate_integer() const {
-    return pow(this->left->evaluate_integer(), this->right->evaluate_integer());
+    return std::pow(this->left->evaluate_integer(), this->right->evaluate_integer());
 }
 
-double PowerExpression::evaluate_number() const {
-    return pow(this->left->evaluate_number(), this->right->evaluate_number());
+number_t PowerExpression::evaluate_number() const {
+    return std::pow(this->left->evaluate_number(), this->right->evaluate_number());
+}
+
+void PowerExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == integer) {
+        bytecode.emit_binary(this->left, this->right, integer, Opcode::power_integer);
+    } else if (type == number) {
+        bytecode.emit_binary(this->left, this->right, number, Opcode::power_number);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void PowerExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
 }
 
 NegateExpression::NegateExpression(const ConstExpression_ptr operand)
@@ -174,10 +293,30 @@ int64_t NegateExpression::evaluate_integer() const {
     return -this->operand->evaluate_integer();
 }
 
-double NegateExpression::evaluate_number() const {
+number_t NegateExpression::evaluate_number() const {
     return -this->operand->evaluate_number();
 }
 
+void NegateExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == integer) {
+        bytecode.emit_expression(this->operand, integer);
+        bytecode.emit(Opcode::negate_integer, 0);
+    } else if (type == number) {
+        bytecode.emit_expression(this->operand, number);
+        bytecode.emit(Opcode::negate_number, 0);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+ConstExpression_ptr NegateExpression::get_negated_operand() const {
+    return this->operand;
+}
+
+void NegateExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->operand->collect_variables(variables);
+}
+
 MultiplyExpression::MultiplyExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
     : Expression(get_common_number_type(left, right)), left(left), right(right) {
 }
@@ -186,10 +325,25 @@ int64_t MultiplyExpression::evaluate_integer() const {
     return this->left->evaluate_integer() * this->right->evaluate_integer();
 }
 
-double MultiplyExpression::evaluate_number() const {
+number_t MultiplyExpression::evaluate_number() const {
     return this->left->evaluate_number() * this->right->evaluate_number();
 }
 
+void MultiplyExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == integer) {
+        bytecode.emit_binary(this->left, this->right, integer, Opcode::multiply_integer);
+    } else if (type == number) {
+        bytecode.emit_binary(this->left, this->right, number, Opcode::multiply_number);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void MultiplyExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
+}
+
 DivideExpression::DivideExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
     : Expression(get_common_number_type(left, right)), left(left), right(right) {
 }
@@ -198,10 +352,25 @@ int64_t DivideExpression::evaluate_integer() const {
     return this->left->evaluate_integer() / this->right->evaluate_integer();
 }
 
-double DivideExpression::evaluate_number() const {
+number_t DivideExpression::evaluate_number() const {
     return this->left->evaluate_number() / this->right->evaluate_number();
 }
 
+void DivideExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == integer) {
+        bytecode.emit_binary(this->left, this->right, integer, Opcode::divide_integer);
+    } else if (type == number) {
+        bytecode.emit_binary(this->left, this->right, number, Opcode::divide_number);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void DivideExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
+}
+
 ModuloExpression::ModuloExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
     : Expression(get_common_number_type(left, right)), left(left), right(right) {
 }
@@ -210,8 +379,23 @@ int64_t ModuloExpression::evaluate_integer() const {
     return this->left->evaluate_integer() % this->right->evaluate_integer();
 }
 
-double ModuloExpression::evaluate_number() const {
-    return fmod(this->left->evaluate_number(), this->right->evaluate_number());
+number_t ModuloExpression::evaluate_number() const {
+    return std::fmod(this->left->evaluate_number(), this->right->evaluate_number());
+}
+
+void ModuloExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == integer) {
+        bytecode.emit_binary(this->left, this->right, integer, Opcode::modulo_integer);
+    } else if (type == number) {
+        bytecode.emit_binary(this->left, this->right, number, Opcode::modulo_number);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void ModuloExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
 }
 
 FloorDivideExpression::FloorDivideExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
@@ -222,8 +406,23 @@ int64_t FloorDivideExpression::evaluate_integer() const {
     return this->left->evaluate_integer() / this->right->evaluate_integer();
 }
 
-double FloorDivideExpression::evaluate_number() const {
-    return floor(this->left->evaluate_number() / this->right->evaluate_number());
+number_t FloorDivideExpression::evaluate_number() const {
+    return std::floor(this->left->evaluate_number() / this->right->evaluate_number());
+}
+
+void FloorDivideExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == integer) {
+        bytecode.emit_binary(this->left, this->right, integer, Opcode::floor_divide_integer);
+    } else if (type == number) {
+        bytecode.emit_binary(this->left, this->right, number, Opcode::floor_divide_number);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void FloorDivideExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
 }
 
 AddExpression::AddExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
@@ -234,10 +433,25 @@ int64_t AddExpression::evaluate_integer() const {
     return this->left->evaluate_integer() + this->right->evaluate_integer();
 }
 
-double AddExpression::evaluate_number() const {
+number_t AddExpression::evaluate_number() const {
     return this->left->evaluate_number() + this->right->evaluate_number();
 }
 
+void AddExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == integer) {
+        bytecode.emit_binary(this->left, this->right, integer, Opcode::add_integer);
+    } else if (type == number) {
+        bytecode.emit_binary(this->left, this->right, number, Opcode::add_number);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void AddExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
+}
+
 SubtractExpression::SubtractExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
     : Expression(get_common_number_type(left, right)), left(left), right(right) {
 }
@@ -246,10 +460,25 @@ int64_t SubtractExpression::evaluate_integer() const {
     return this->left->evaluate_integer() - this->right->evaluate_integer();
 }
 
-double SubtractExpression::evaluate_number() const {
+number_t SubtractExpression::evaluate_number() const {
     return this->left->evaluate_number() - this->right->evaluate_number();
 }
 
+void SubtractExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == integer) {
+        bytecode.emit_binary(this->left, this->right, integer, Opcode::subtract_integer);
+    } else if (type == number) {
+        bytecode.emit_binary(this->left, this->right, number, Opcode::subtract_number);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void SubtractExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
+}
+
 ShiftLeftExpression::ShiftLeftExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
     : Expression(integer), left(left), right(right) {
 }
@@ -258,6 +487,19 @@ int64_t ShiftLeftExpression::evaluate_integer() const {
     return this->left->evaluate_integer() << this->right->evaluate_integer();
 }
 
+void ShiftLeftExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == integer) {
+        bytecode.emit_binary(this->left, this->right, integer, Opcode::shift_left);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void ShiftLeftExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
+}
+
 ShiftRightExpression::ShiftRightExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
     : Expression(integer), left(left), right(right) {
 }
@@ -266,6 +508,19 @@ int64_t ShiftRightExpression::evaluate_integer() const {
     return this->left->evaluate_integer() >> this->right->evaluate_integer();
 }
 
+void ShiftRightExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == integer) {
+        bytecode.emit_binary(this->left, this->right, integer, Opcode::shift_right);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void ShiftRightExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
+}
+
 BitAndExpression::BitAndExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
     : Expression(integer), left(left), right(right) {
 }
@@ -274,6 +529,19 @@ int64_t BitAndExpression::evaluate_integer() const {
     return this->left->evaluate_integer() & this->right->evaluate_integer();
 }
 
+void BitAndExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == integer) {
+        bytecode.emit_binary(this->left, this->right, integer, Opcode::bit_and);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void BitAndExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
+}
+
 BitXorExpression::BitXorExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
     : Expression(integer), left(left), right(right) {
 }
@@ -282,6 +550,19 @@ int64_t BitXorExpression::evaluate_integer() const {
     return this->left->evaluate_integer() ^ this->right->evaluate_integer();
 }
 
+void BitXorExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == integer) {
+        bytecode.emit_binary(this->left, this->right, integer, Opcode::bit_xor);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void BitXorExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
+}
+
 BitOrExpression::BitOrExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
     : Expression(integer), left(left), right(right) {
 }
@@ -290,6 +571,19 @@ int64_t BitOrExpression::evaluate_integer() const {
     return this->left->evaluate_integer() | this->right->evaluate_integer();
 }
 
+void BitOrExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == integer) {
+        bytecode.emit_binary(this->left, this->right, integer, Opcode::bit_or);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void BitOrExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
+}
+
 GreaterExpression::GreaterExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
     : Expression(boolean), left(left), right(right) {
     check_number_types(left, right);
@@ -299,6 +593,19 @@ bool GreaterExpression::evaluate_boolean() const {
     return this->left->evaluate_number() > this->right->evaluate_number();
 }
 
+void GreaterExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == boolean) {
+        bytecode.emit_binary(this->left, this->right, number, Opcode::greater);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void GreaterExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
+}
+
 LessExpression::LessExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
     : Expression(boolean), left(left), right(right) {
     check_number_types(left, right);
@@ -308,6 +615,19 @@ bool LessExpression::evaluate_boolean() const {
     return this->left->evaluate_number() < this->right->evaluate_number();
 }
 
+void LessExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == boolean) {
+        bytecode.emit_binary(this->left, this->right, number, Opcode::less);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void LessExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
+}
+
 GreaterEqualExpression::GreaterEqualExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
     : Expression(boolean), left(left), right(right) {
     check_number_types(left, right);
@@ -317,6 +637,19 @@ bool GreaterEqualExpression::evaluate_boolean() const {
     return this->left->evaluate_number() >= this->right->evaluate_number();
 }
 
+void GreaterEqualExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == boolean) {
+        bytecode.emit_binary(this->left, this->right, number, Opcode::greater_equal);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void GreaterEqualExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
+}
+
 LessEqualExpression::LessEqualExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
     : Expression(boolean), left(left), right(right) {
     check_number_types(left, right);
@@ -326,6 +659,19 @@ bool LessEqualExpression::evaluate_boolean() const {
     return this->left->evaluate_number() <= this->right->evaluate_number();
 }
 
+void LessEqualExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == boolean) {
+        bytecode.emit_binary(this->left, this->right, number, Opcode::less_equal);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void LessEqualExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
+}
+
 EqualExpression::EqualExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
     : Expression(boolean), left(left), right(right) {
     check_number_types(left, right);
@@ -335,6 +681,19 @@ bool EqualExpression::evaluate_boolean() const {
     return this->left->evaluate_number() == this->right->evaluate_number();
 }
 
+void EqualExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == boolean) {
+        bytecode.emit_binary(this->left, this->right, number, Opcode::equal);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void EqualExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
+}
+
 UnequalExpression::UnequalExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
     : Expression(boolean), left(left), right(right) {
     check_number_types(left, right);
@@ -344,6 +703,19 @@ bool UnequalExpression::evaluate_boolean() const {
     return this->left->evaluate_number() != this->right->evaluate_number();
 }
 
+void UnequalExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == boolean) {
+        bytecode.emit_binary(this->left, this->right, number, Opcode::unequal);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void UnequalExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
+}
+
 NotExpression::NotExpression(const ConstExpression_ptr operand)
     : Expression(boolean), operand(operand) {
     check_boolean_types(operand, operand);
@@ -353,6 +725,19 @@ bool NotExpression::evaluate_boolean() const {
     return !this->operand->evaluate_boolean();
 }
 
+void NotExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == boolean) {
+        bytecode.emit_expression(this->operand, boolean);
+        bytecode.emit(Opcode::logical_not, 0);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void NotExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->operand->collect_variables(variables);
+}
+
 AndExpression::AndExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
     : Expression(boolean), left(left), right(right) {
     check_boolean_types(left, right);
@@ -362,6 +747,22 @@ bool AndExpression::evaluate_boolean() const {
     return this->left->evaluate_boolean() && this->right->evaluate_boolean();
 }
 
+void AndExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == boolean) {
+        bytecode.emit_expression(this->left, boolean);
+        const size_t jump = bytecode.emit_jump(Opcode::jump_if_false_or_pop);
+        bytecode.emit_expression(this->right, boolean);
+        bytecode.patch_jump(jump);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void AndExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
+}
+
 OrExpression::OrExpression(const ConstExpression_ptr left, const ConstExpression_ptr right)
     : Expression(boolean), left(left), right(right) {
     check_boolean_types(left, right);
@@ -370,3 +771,19 @@ OrExpression::OrExpression(const ConstExpression_ptr left, const ConstExpression
 bool OrExpression::evaluate_boolean() const {
     return this->left->evaluate_boolean() || this->right->evaluate_boolean();
 }
+
+void OrExpression::emit(Bytecode &bytecode, const Type type) const {
+    if (type == boolean) {
+        bytecode.emit_expression(this->left, boolean);
+        const size_t jump = bytecode.emit_jump(Opcode::jump_if_true_or_pop);
+        bytecode.emit_expression(this->right, boolean);
+        bytecode.patch_jump(jump);
+    } else {
+        Expression::emit(bytecode, type);
+    }
+}
+
+void OrExpression::collect_variables(std::vector<ConstVariable_ptr> &variables) const {
+    this->left->collect_variables(variables);
+    this->right->collect_variables(variables);
+}
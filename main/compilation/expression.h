@@ -6,6 +6,8 @@
 #include <string>
 #include <vector>
 
+class Bytecode; // NOTE: forward declaration to avoid cyclic include
+
 class Expression;
 using Expression_ptr = std::shared_ptr<Expression>;
 using ConstExpression_ptr = std::shared_ptr<const Expression>;
@@ -21,9 +23,13 @@ public:
 
     virtual bool evaluate_boolean() const;
     virtual int64_t evaluate_integer() const;
-    virtual double evaluate_number() const;
+    virtual number_t evaluate_number() const;
     virtual std::string evaluate_string() const;
     virtual std::string evaluate_identifier() const;
+    virtual void emit(Bytecode &bytecode, const Type type) const;
+    virtual bool is_constant() const;
+    virtual ConstExpression_ptr get_negated_operand() const;
+    virtual void collect_variables(std::vector<ConstVariable_ptr> &variables) const;
     bool is_numbery() const;
     int print_to_buffer(char *buffer) const;
 };
@@ -35,6 +41,8 @@ private:
 public:
     BooleanExpression(const bool value);
     bool evaluate_boolean() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    bool is_constant() const override;
 };
 
 class StringExpression : public Expression {
@@ -44,6 +52,7 @@ private:
 public:
     StringExpression(const std::string value);
     std::string evaluate_string() const override;
+    bool is_constant() const override;
 };
 
 class IntegerExpression : public Expression {
@@ -53,16 +62,20 @@ private:
 public:
     IntegerExpression(const int64_t value);
     int64_t evaluate_integer() const override;
-    double evaluate_number() const override;
+    number_t evaluate_number() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    bool is_constant() const override;
 };
 
 class NumberExpression : public Expression {
 private:
-    const double value;
+    const number_t value;
 
 public:
-    NumberExpression(const double value);
-    double evaluate_number() const override;
+    NumberExpression(const number_t value);
+    number_t evaluate_number() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    bool is_constant() const override;
 };
 
 class VariableExpression : public Expression {
@@ -73,9 +86,11 @@ public:
     VariableExpression(const ConstVariable_ptr variable);
     bool evaluate_boolean() const override;
     int64_t evaluate_integer() const override;
-    double evaluate_number() const override;
+    number_t evaluate_number() const override;
     std::string evaluate_string() const override;
     std::string evaluate_identifier() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class PowerExpression : public Expression {
@@ -86,7 +101,9 @@ private:
 public:
     PowerExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     int64_t evaluate_integer() const override;
-    double evaluate_number() const override;
+    number_t evaluate_number() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class NegateExpression : public Expression {
@@ -96,7 +113,10 @@ private:
 public:
     NegateExpression(const ConstExpression_ptr operand);
     int64_t evaluate_integer() const override;
-    double evaluate_number() const override;
+    number_t evaluate_number() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    ConstExpression_ptr get_negated_operand() const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class MultiplyExpression : public Expression {
@@ -107,7 +127,9 @@ private:
 public:
     MultiplyExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     int64_t evaluate_integer() const override;
-    double evaluate_number() const override;
+    number_t evaluate_number() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class DivideExpression : public Expression {
@@ -118,7 +140,9 @@ private:
 public:
     DivideExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     int64_t evaluate_integer() const override;
-    double evaluate_number() const override;
+    number_t evaluate_number() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class ModuloExpression : public Expression {
@@ -129,7 +153,9 @@ private:
 public:
     ModuloExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     int64_t evaluate_integer() const override;
-    double evaluate_number() const override;
+    number_t evaluate_number() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class FloorDivideExpression : public Expression {
@@ -140,7 +166,9 @@ private:
 public:
     FloorDivideExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     int64_t evaluate_integer() const override;
-    double evaluate_number() const override;
+    number_t evaluate_number() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class AddExpression : public Expression {
@@ -151,7 +179,9 @@ private:
 public:
     AddExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     int64_t evaluate_integer() const override;
-    double evaluate_number() const override;
+    number_t evaluate_number() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class SubtractExpression : public Expression {
@@ -162,7 +192,9 @@ private:
 public:
     SubtractExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     int64_t evaluate_integer() const override;
-    double evaluate_number() const override;
+    number_t evaluate_number() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class ShiftLeftExpression : public Expression {
@@ -173,6 +205,8 @@ private:
 public:
     ShiftLeftExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     int64_t evaluate_integer() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class ShiftRightExpression : public Expression {
@@ -183,6 +217,8 @@ private:
 public:
     ShiftRightExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     int64_t evaluate_integer() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class BitAndExpression : public Expression {
@@ -193,6 +229,8 @@ private:
 public:
     BitAndExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     int64_t evaluate_integer() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class BitXorExpression : public Expression {
@@ -203,6 +241,8 @@ private:
 public:
     BitXorExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     int64_t evaluate_integer() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class BitOrExpression : public Expression {
@@ -213,6 +253,8 @@ private:
 public:
     BitOrExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     int64_t evaluate_integer() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class GreaterExpression : public Expression {
@@ -223,6 +265,8 @@ private:
 public:
     GreaterExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     bool evaluate_boolean() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class LessExpression : public Expression {
@@ -233,6 +277,8 @@ private:
 public:
     LessExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     bool evaluate_boolean() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class GreaterEqualExpression : public Expression {
@@ -243,6 +289,8 @@ private:
 public:
     GreaterEqualExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     bool evaluate_boolean() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class LessEqualExpression : public Expression {
@@ -253,6 +301,8 @@ private:
 public:
     LessEqualExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     bool evaluate_boolean() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class EqualExpression : public Expression {
@@ -263,6 +313,8 @@ private:
 public:
     EqualExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     bool evaluate_boolean() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class UnequalExpression : public Expression {
@@ -273,6 +325,8 @@ private:
 public:
     UnequalExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     bool evaluate_boolean() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class NotExpression : public Expression {
@@ -282,6 +336,8 @@ private:
 public:
     NotExpression(const ConstExpression_ptr operand);
     bool evaluate_boolean() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class AndExpression : public Expression {
@@ -292,6 +348,8 @@ private:
 public:
     AndExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     bool evaluate_boolean() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
 
 class OrExpression : public Expression {
@@ -302,4 +360,6 @@ private:
 public:
     OrExpression(const ConstExpression_ptr left, const ConstExpression_ptr right);
     bool evaluate_boolean() const override;
+    void emit(Bytecode &bytecode, const Type type) const override;
+    void collect_variables(std::vector<ConstVariable_ptr> &variables) const override;
 };
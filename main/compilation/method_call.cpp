@@ -1,10 +1,10 @@
 #include "method_call.h"
 
-MethodCall::MethodCall(const Module_ptr module, const std::string method_name, const std::vector<ConstExpression_ptr> arguments)
-    : module(module), method_name(method_name), arguments(arguments) {
+MethodCall::MethodCall(const Module_ptr module, const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments)
+    : module(module), method_id(method_id), arguments(arguments) {
 }
 
 bool MethodCall::run() {
-    this->module->call_with_shadows(this->method_name, this->arguments);
+    this->module->call_with_shadows(this->method_id, this->arguments);
     return true;
 }
\ No newline at end of file
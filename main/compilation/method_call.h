@@ -9,9 +9,9 @@
 class MethodCall : public Action {
 public:
     const Module_ptr module;
-    const std::string method_name;
+    const unsigned int method_id;
     const std::vector<ConstExpression_ptr> arguments;
 
-    MethodCall(const Module_ptr module, const std::string method_name, const std::vector<ConstExpression_ptr> arguments);
+    MethodCall(const Module_ptr module, const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments);
     bool run() override;
 };
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "optimizer.h"
+#include <cmath>
+#include <stdexcept>
+
+unsigned int Optimizer::eliminated_nodes = 0;
+
+ConstExpression_ptr Optimizer::fold(const ConstExpression_ptr expression, const unsigned int operand_count) {
+    try {
+        switch (expression->type) {
+        case boolean:
+            Optimizer::eliminated_nodes += operand_count;
+            return std::make_shared<BooleanExpression>(expression->evaluate_boolean());
+        case integer: {
+            // integer nodes are also evaluated as numbers (e.g. 1 / 2), so both results have to agree
+            const int64_t value = expression->evaluate_integer();
+            const number_t number_value = expression->evaluate_number();
+            if ((number_t)value != number_value || (value == 0 && std::signbit(number_value))) {
+                return expression;
+            }
+            Optimizer::eliminated_nodes += operand_count;
+            return std::make_shared<IntegerExpression>(value);
+        }
+        case number:
+            Optimizer::eliminated_nodes += operand_count;
+            return std::make_shared<NumberExpression>(expression->evaluate_number());
+        default:
+            return expression;
+        }
+    } catch (const std::runtime_error &) {
+        return expression;
+    }
+}
+
+ConstExpression_ptr Optimizer::power(const ConstExpression_ptr left, const ConstExpression_ptr right) {
+    const ConstExpression_ptr expression = Optimizer::binary<PowerExpression>(left, right);
+    if (expression->is_constant() || !right->is_constant() || right->type != integer) {
+        return expression;
+    }
+    // integer powers use std::pow, which differs from x * x for large integers
+    if (left->type != number) {
+        return expression;
+    }
+    const int64_t exponent = right->evaluate_integer();
+    if (exponent == 1) {
+        Optimizer::eliminated_nodes += 2;
+        return left;
+    }
+    if (exponent == 2) {
+        Optimizer::eliminated_nodes += 1;
+        return std::make_shared<MultiplyExpression>(left, left);
+    }
+    return expression;
+}
+
+ConstExpression_ptr Optimizer::multiply(const ConstExpression_ptr left, const ConstExpression_ptr right) {
+    const ConstExpression_ptr expression = Optimizer::binary<MultiplyExpression>(left, right);
+    if (expression->is_constant()) {
+        return expression;
+    }
+    const ConstExpression_ptr factor = left->is_constant() ? left : right;
+    const ConstExpression_ptr other = left->is_constant() ? right : left;
+    if (!factor->is_constant() || factor->type != integer) {
+        return expression;
+    }
+    if (factor->evaluate_integer() == 1 && other->type == expression->type) {
+        Optimizer::eliminated_nodes += 2;
+        return other;
+    }
+    // x * 0 is not reduced, because x can be NaN or infinite when evaluated as number
+    return expression;
+}
+
+ConstExpression_ptr Optimizer::negate(const ConstExpression_ptr operand) {
+    const ConstExpression_ptr inner_operand = operand->get_negated_operand();
+    if (inner_operand && operand->type != boolean && inner_operand->type == operand->type) {
+        Optimizer::eliminated_nodes += 2;
+        return inner_operand;
+    }
+    return Optimizer::unary<NegateExpression>(operand);
+}
+
+ConstExpression_ptr Optimizer::logical_and(const ConstExpression_ptr left, const ConstExpression_ptr right) {
+    const ConstExpression_ptr expression = Optimizer::binary<AndExpression>(left, right);
+    if (expression->is_constant() || !left->is_constant()) {
+        return expression;
+    }
+    if (left->evaluate_boolean()) {
+        return expression;
+    }
+    Optimizer::eliminated_nodes += 2;
+    return left;
+}
+
+ConstExpression_ptr Optimizer::logical_or(const ConstExpression_ptr left, const ConstExpression_ptr right) {
+    const ConstExpression_ptr expression = Optimizer::binary<OrExpression>(left, right);
+    if (expression->is_constant() || !left->is_constant()) {
+        return expression;
+    }
+    if (!left->evaluate_boolean()) {
+        return expression;
+    }
+    Optimizer::eliminated_nodes += 2;
+    return left;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "expression.h"
+#include <memory>
+
+class Optimizer {
+private:
+    static ConstExpression_ptr fold(const ConstExpression_ptr expression, const unsigned int operand_count);
+
+public:
+    static unsigned int eliminated_nodes;
+
+    template <class T>
+    static ConstExpression_ptr unary(const ConstExpression_ptr operand) {
+        const ConstExpression_ptr expression = std::make_shared<T>(operand);
+        return operand->is_constant() ? fold(expression, 1) : expression;
+    }
+    template <class T>
+    static ConstExpression_ptr binary(const ConstExpression_ptr left, const ConstExpression_ptr right) {
+        const ConstExpression_ptr expression = std::make_shared<T>(left, right);
+        return left->is_constant() && right->is_constant() ? fold(expression, 2) : expression;
+    }
+    template <class T>
+    static ConstExpression_ptr division(const ConstExpression_ptr left, const ConstExpression_ptr right) {
+        if (right->is_constant() && right->type == integer && right->evaluate_integer() == 0) {
+            // integer division by zero must not be evaluated at compile time
+            return std::make_shared<T>(left, right);
+        }
+        return binary<T>(left, right);
+    }
+    static ConstExpression_ptr power(const ConstExpression_ptr left, const ConstExpression_ptr right);
+    static ConstExpression_ptr multiply(const ConstExpression_ptr left, const ConstExpression_ptr right);
+    static ConstExpression_ptr negate(const ConstExpression_ptr operand);
+    static ConstExpression_ptr logical_and(const ConstExpression_ptr left, const ConstExpression_ptr right);
+    static ConstExpression_ptr logical_or(const ConstExpression_ptr left, const ConstExpression_ptr right);
+};
@@ -1,10 +1,11 @@
 #include "property_assignment.h"
 
-PropertyAssignment::PropertyAssignment(const Module_ptr module, const std::string property_name, const ConstExpression_ptr expression)
-    : module(module), property_name(property_name), expression(expression) {
+PropertyAssignment::PropertyAssignment(const Module_ptr module, const std::string property_name, const ConstExpression_ptr expression,
+                                       const bool from_expander)
+    : module(module), property_name(property_name), expression(expression), from_expander(from_expander) {
 }
 
 bool PropertyAssignment::run() {
-    this->module->write_property(this->property_name, this->expression);
+    this->module->write_property(this->property_name, this->expression, this->from_expander);
     return true;
 }
\ No newline at end of file
@@ -9,7 +9,9 @@ public:
     const Module_ptr module;
     const std::string property_name;
     const ConstExpression_ptr expression;
+    const bool from_expander;
 
-    PropertyAssignment(const Module_ptr module, const std::string property_name, const ConstExpression_ptr expression);
+    PropertyAssignment(const Module_ptr module, const std::string property_name, const ConstExpression_ptr expression,
+                       const bool from_expander = false);
     bool run() override;
 };
\ No newline at end of file
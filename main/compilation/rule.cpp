@@ -1,5 +1,38 @@
 #include "rule.h"
 
+unsigned int Rule::evaluated_count = 0;
+unsigned int Rule::skipped_count = 0;
+
 Rule::Rule(const ConstExpression_ptr condition, const Routine_ptr routine)
     : condition(condition), routine(routine) {
+    std::vector<ConstVariable_ptr> variables;
+    condition->collect_variables(variables);
+    for (auto const &variable : variables) {
+        bool is_known = false;
+        for (auto const &dependency : this->dependencies) {
+            is_known |= dependency.first == variable;
+        }
+        if (!is_known) {
+            this->dependencies.push_back({variable, variable->generation});
+        }
+    }
+}
+
+bool Rule::evaluate_condition() {
+    bool is_dirty = !this->has_condition_value;
+    for (auto &[variable, generation] : this->dependencies) {
+        if (variable->generation != generation) {
+            generation = variable->generation;
+            is_dirty = true;
+        }
+    }
+    if (!is_dirty) {
+        Rule::skipped_count++;
+        return this->condition_value;
+    }
+    Rule::evaluated_count++;
+    this->has_condition_value = false; // failed evaluations are repeated in the next cycle
+    this->condition_value = this->condition->evaluate_boolean();
+    this->has_condition_value = true;
+    return this->condition_value;
 }
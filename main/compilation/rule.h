@@ -3,14 +3,26 @@
 #include "action.h"
 #include "expression.h"
 #include "routine.h"
+#include "variable.h"
 #include <memory>
+#include <utility>
+#include <vector>
 
 class Rule;
 using Rule_ptr = std::shared_ptr<Rule>;
 
 class Rule {
+private:
+    std::vector<std::pair<ConstVariable_ptr, unsigned int>> dependencies;
+    bool has_condition_value = false;
+    bool condition_value = false;
+
 public:
+    static unsigned int evaluated_count;
+    static unsigned int skipped_count;
+
     const ConstExpression_ptr condition;
     const Routine_ptr routine;
     Rule(const ConstExpression_ptr condition, const Routine_ptr routine);
+    bool evaluate_condition();
 };
\ No newline at end of file
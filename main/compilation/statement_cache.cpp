@@ -0,0 +1,157 @@
+#include "statement_cache.h"
+#include "../utils/timing.h"
+#include <cctype>
+#include <stdlib.h>
+
+std::map<std::string, StatementCache::Entry> StatementCache::entries;
+std::string StatementCache::key;
+std::vector<StatementCache::Literal> StatementCache::literals;
+std::vector<Variable_ptr> StatementCache::slots;
+bool StatementCache::is_recording = false;
+unsigned long int StatementCache::use_count = 0;
+unsigned int StatementCache::hit_count = 0;
+unsigned int StatementCache::miss_count = 0;
+uint64_t StatementCache::hit_micros = 0;
+
+bool StatementCache::scan(const char *line, const bool from_expander) {
+    StatementCache::key.assign(from_expander ? "<" : ">");
+    StatementCache::literals.clear();
+    size_t i = 0;
+    while (line[i] != '\0') {
+        const unsigned char c = line[i];
+        if (c == '"' || c == '\'') {
+            size_t end = i + 1;
+            while (line[end] != '\0' && line[end] != c) {
+                end += line[end] == '\\' && line[end + 1] != '\0' ? 2 : 1;
+            }
+            end += line[end] == '\0' ? 0 : 1;
+            StatementCache::key.append(line + i, end - i);
+            i = end;
+        } else if (c == '#') {
+            StatementCache::key.append(line + i);
+            break;
+        } else if (std::isalpha(c) || c == '_') {
+            size_t end = i + 1;
+            while (std::isalnum((unsigned char)line[end]) || line[end] == '_') {
+                end++;
+            }
+            StatementCache::key.append(line + i, end - i);
+            i = end;
+        } else if (std::isdigit(c) || (c == '.' && std::isdigit((unsigned char)line[i + 1]))) {
+            size_t integer_length = 0;
+            uint64_t integer_value = 0;
+            if (std::isdigit(c)) {
+                const bool is_hex = c == '0' && (line[i + 1] == 'x' || line[i + 1] == 'X') && std::isxdigit((unsigned char)line[i + 2]);
+                const uint64_t base = is_hex ? 16 : 10;
+                size_t end = is_hex ? i + 2 : i;
+                bool overflow = false;
+                while (is_hex ? std::isxdigit((unsigned char)line[end]) : std::isdigit((unsigned char)line[end])) {
+                    const uint64_t last = integer_value;
+                    const char digit = line[end];
+                    integer_value = integer_value * base + (std::isdigit((unsigned char)digit) ? digit - '0' : std::tolower(digit) - 'a' + 0xa);
+                    if (integer_value < last) {
+                        overflow = true;
+                        break;
+                    }
+                    end++;
+                }
+                integer_length = overflow ? 0 : end - i;
+            }
+            char *rest = nullptr;
+            const double number_value = strtod(line + i, &rest);
+            const size_t number_length = rest - (line + i);
+            if (integer_length > 0 && integer_length >= number_length) {
+                StatementCache::literals.push_back({i, integer, (int64_t)integer_value, 0});
+                StatementCache::key += '\x01';
+                i += integer_length;
+            } else {
+                StatementCache::literals.push_back({i, number, 0, (number_t)number_value});
+                StatementCache::key += '\x02';
+                i += number_length;
+            }
+        } else if (c < ' ' && c != '\t' && c != '\r' && c != '\n') {
+            return false;
+        } else {
+            StatementCache::key += c;
+            i++;
+        }
+    }
+    return true;
+}
+
+bool StatementCache::run(const char *line, const bool from_expander) {
+    const unsigned long int start = micros();
+    StatementCache::is_recording = false;
+    if (!StatementCache::scan(line, from_expander)) {
+        StatementCache::key.clear();
+        return false;
+    }
+    const auto it = StatementCache::entries.find(StatementCache::key);
+    if (it == StatementCache::entries.end()) {
+        return false;
+    }
+    Entry &entry = it->second;
+    for (size_t i = 0; i < StatementCache::literals.size(); ++i) {
+        const Literal &literal = StatementCache::literals[i];
+        if (literal.type == integer) {
+            entry.slots[i]->set_integer(literal.integer_value);
+        } else {
+            entry.slots[i]->set_number(literal.number_value);
+        }
+    }
+    entry.last_use = ++StatementCache::use_count;
+    const Action_ptr action = entry.action; // the entry might be evicted by nested statements
+    action->run();
+    StatementCache::hit_count++;
+    StatementCache::hit_micros += micros_since(start);
+    return true;
+}
+
+void StatementCache::record() {
+    StatementCache::is_recording = !StatementCache::key.empty();
+    StatementCache::slots.assign(StatementCache::literals.size(), nullptr);
+}
+
+ConstExpression_ptr StatementCache::literal(const size_t start, const ConstExpression_ptr expression) {
+    if (!StatementCache::is_recording) {
+        return expression;
+    }
+    for (size_t i = 0; i < StatementCache::literals.size(); ++i) {
+        if (StatementCache::literals[i].start == start && StatementCache::literals[i].type == expression->type && !StatementCache::slots[i]) {
+            const Variable_ptr slot = expression->type == integer
+                                          ? (Variable_ptr)std::make_shared<IntegerVariable>(expression->evaluate_integer())
+                                          : (Variable_ptr)std::make_shared<NumberVariable>(expression->evaluate_number());
+            StatementCache::slots[i] = slot;
+            return std::make_shared<VariableExpression>(slot);
+        }
+    }
+    StatementCache::is_recording = false;
+    return expression;
+}
+
+void StatementCache::insert(const Action_ptr action) {
+    if (!StatementCache::is_recording) {
+        return;
+    }
+    StatementCache::is_recording = false;
+    for (auto const &slot : StatementCache::slots) {
+        if (!slot) {
+            return;
+        }
+    }
+    StatementCache::miss_count++;
+    if (StatementCache::entries.size() >= StatementCache::max_size) {
+        auto victim = StatementCache::entries.begin();
+        for (auto it = StatementCache::entries.begin(); it != StatementCache::entries.end(); ++it) {
+            if (it->second.last_use < victim->second.last_use) {
+                victim = it;
+            }
+        }
+        StatementCache::entries.erase(victim);
+    }
+    StatementCache::entries[StatementCache::key] = {StatementCache::slots, action, ++StatementCache::use_count};
+}
+
+size_t StatementCache::size() {
+    return StatementCache::entries.size();
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "action.h"
+#include "expression.h"
+#include "type.h"
+#include "variable.h"
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class StatementCache {
+private:
+    struct Literal {
+        size_t start;
+        Type type;
+        int64_t integer_value;
+        number_t number_value;
+    };
+    struct Entry {
+        std::vector<Variable_ptr> slots;
+        Action_ptr action;
+        unsigned long int last_use;
+    };
+
+    static std::map<std::string, Entry> entries;
+    static std::string key;
+    static std::vector<Literal> literals;
+    static std::vector<Variable_ptr> slots;
+    static bool is_recording;
+    static unsigned long int use_count;
+
+    static bool scan(const char *line, const bool from_expander);
+
+public:
+    static const size_t max_size = 32;
+    static unsigned int hit_count;
+    static unsigned int miss_count;
+    static uint64_t hit_micros;
+
+    static bool run(const char *line, const bool from_expander);
+    static void record();
+    static ConstExpression_ptr literal(const size_t start, const ConstExpression_ptr expression);
+    static void insert(const Action_ptr action);
+    static size_t size();
+};
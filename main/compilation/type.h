@@ -1,5 +1,14 @@
 #pragma once
 
+#include "sdkconfig.h"
+
+// values accumulated over a long time (e.g. odometry) should use double explicitly
+#ifdef CONFIG_LIZARD_SINGLE_PRECISION
+using number_t = float;
+#else
+using number_t = double;
+#endif
+
 enum Type {
     boolean = 1,
     integer = 2,
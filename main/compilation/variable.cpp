@@ -1,19 +1,57 @@
 #include "variable.h"
+#include "../utils/format.h"
 #include "expression.h"
 #include <stdexcept>
 
-Variable::Variable(const Type type) : type(type) {
+Variable::Variable(const Type type) : type(type), integer_value(0) {
+    if (type == string || type == identifier) {
+        this->string_value = new std::string();
+    }
+}
+
+Variable::~Variable() {
+    if (this->type == string || this->type == identifier) {
+        delete this->string_value;
+    }
+}
+
+void Variable::set_boolean(const bool value) {
+    if (this->boolean_value != value) {
+        this->boolean_value = value;
+        this->generation++;
+    }
+}
+
+void Variable::set_integer(const int64_t value) {
+    if (this->integer_value != value) {
+        this->integer_value = value;
+        this->generation++;
+    }
+}
+
+void Variable::set_number(const number_t value) {
+    if (this->number_value != value) {
+        this->number_value = value;
+        this->generation++;
+    }
+}
+
+void Variable::set_string(const std::string value) {
+    if (*this->string_value != value) {
+        *this->string_value = value;
+        this->generation++;
+    }
 }
 
 void Variable::assign(const ConstExpression_ptr expression) {
     if (this->type == boolean && expression->type == boolean) {
-        this->boolean_value = expression->evaluate_boolean();
+        this->set_boolean(expression->evaluate_boolean());
     } else if (this->type == integer && expression->type == integer) {
-        this->integer_value = expression->evaluate_integer();
+        this->set_integer(expression->evaluate_integer());
     } else if (this->type == number && expression->is_numbery()) {
-        this->number_value = expression->evaluate_number();
+        this->set_number(expression->evaluate_number());
     } else if (this->type == string && expression->type == string) {
-        this->string_value = expression->evaluate_string();
+        this->set_string(expression->evaluate_string());
     } else if (this->type == identifier && expression->type == identifier) {
         throw std::runtime_error("assignment of identifiers is forbidden");
     } else {
@@ -26,13 +64,13 @@ int Variable::print_to_buffer(char *const buffer) const {
     case boolean:
         return sprintf(buffer, "%s", this->boolean_value ? "true" : "false");
     case integer:
-        return sprintf(buffer, "%lld", this->integer_value);
+        return format_integer(buffer, this->integer_value);
     case number:
-        return sprintf(buffer, "%f", this->number_value);
+        return format_number(buffer, this->number_value, 6);
     case string:
-        return sprintf(buffer, "\"%s\"", this->string_value.c_str());
+        return sprintf(buffer, "\"%s\"", this->string_value->c_str());
     case identifier:
-        return sprintf(buffer, "%s", this->identifier_value.c_str());
+        return sprintf(buffer, "%s", this->string_value->c_str());
     default:
         throw std::runtime_error("variable has an invalid datatype");
     }
@@ -46,14 +84,14 @@ IntegerVariable::IntegerVariable(const int64_t value) : Variable(integer) {
     this->integer_value = value;
 }
 
-NumberVariable::NumberVariable(double value) : Variable(number) {
+NumberVariable::NumberVariable(number_t value) : Variable(number) {
     this->number_value = value;
 }
 
 StringVariable::StringVariable(std::string value) : Variable(string) {
-    this->string_value = value;
+    *this->string_value = value;
 }
 
 IdentifierVariable::IdentifierVariable(std::string value) : Variable(identifier) {
-    this->identifier_value = value;
+    *this->string_value = value;
 }
@@ -15,13 +15,22 @@ using ConstVariable_ptr = std::shared_ptr<const Variable>;
 class Variable {
 public:
     const Type type;
-    bool boolean_value;
-    int64_t integer_value;
-    double number_value;
-    std::string string_value;
-    std::string identifier_value;
+    unsigned int generation = 0;
+    union {
+        bool boolean_value;
+        int64_t integer_value;
+        number_t number_value;
+        std::string *string_value;
+    };
 
     Variable(const Type type);
+    Variable(const Variable &) = delete;
+    Variable &operator=(const Variable &) = delete;
+    ~Variable();
+    void set_boolean(const bool value);
+    void set_integer(const int64_t value);
+    void set_number(const number_t value);
+    void set_string(const std::string value);
     void assign(const ConstExpression_ptr expression);
     int print_to_buffer(char *const buffer) const;
 };
@@ -38,7 +47,7 @@ public:
 
 class NumberVariable : public Variable {
 public:
-    NumberVariable(const double value = 0.0);
+    NumberVariable(const number_t value = 0.0);
 };
 
 class StringVariable : public Variable {
@@ -5,6 +5,7 @@ std::map<const std::string, Module_ptr> Global::modules;
 std::map<const std::string, Routine_ptr> Global::routines;
 std::list<Rule_ptr> Global::rules;
 std::map<const std::string, Variable_ptr> Global::variables;
+unsigned int Global::generation = 0;
 
 Module_ptr Global::get_module(const std::string module_name) {
     if (!modules.count(module_name)) {
@@ -36,6 +37,7 @@ void Global::add_module(const std::string module_name, const Module_ptr module)
     }
     modules[module_name] = module;
     variables[module_name] = std::make_shared<IdentifierVariable>(module_name);
+    generation++;
 }
 
 void Global::add_routine(const std::string routine_name, const Routine_ptr routine) {
@@ -50,6 +52,7 @@ void Global::add_variable(const std::string variable_name, const Variable_ptr va
         throw std::runtime_error("variable \"" + variable_name + "\" already exists");
     }
     variables[variable_name] = variable;
+    generation++;
 }
 
 void Global::add_rule(const Rule_ptr rule) {
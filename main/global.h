@@ -14,6 +14,7 @@ public:
     static std::map<const std::string, Routine_ptr> routines;
     static std::map<const std::string, Variable_ptr> variables;
     static std::list<Rule_ptr> rules;
+    static unsigned int generation;
 
     static Module_ptr get_module(const std::string module_name);
     static Routine_ptr get_routine(const std::string routine_name);
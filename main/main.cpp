@@ -1,11 +1,14 @@
 #include "compilation/await_condition.h"
 #include "compilation/await_routine.h"
+#include "compilation/bytecode.h"
 #include "compilation/expression.h"
 #include "compilation/method_call.h"
+#include "compilation/optimizer.h"
 #include "compilation/property_assignment.h"
 #include "compilation/routine.h"
 #include "compilation/routine_call.h"
 #include "compilation/rule.h"
+#include "compilation/statement_cache.h"
 #include "compilation/variable.h"
 #include "compilation/variable_assignment.h"
 #include "driver/gpio.h"
@@ -17,10 +20,13 @@
 #include "modules/module.h"
 #include "proxy.h"
 #include "storage.h"
+#include "utils/io_task.h"
 #include "utils/ota.h"
+#include "utils/spsc_queue.h"
 #include "utils/tictoc.h"
 #include "utils/timing.h"
 #include "utils/uart.h"
+#include <algorithm>
 #include <chrono>
 #include <functional>
 #include <memory>
@@ -47,17 +53,18 @@ std::string identifier_to_string(const struct owl_ref ref) {
     return std::string(identifier.identifier, identifier.length);
 }
 
-Expression_ptr compile_expression(const struct owl_ref ref);
+ConstExpression_ptr compile_expression(const struct owl_ref ref);
 
-std::vector<ConstExpression_ptr> compile_arguments(const struct owl_ref ref) {
+std::vector<ConstExpression_ptr> compile_arguments(const struct owl_ref ref, const bool bytecode = false) {
     std::vector<ConstExpression_ptr> arguments;
     for (struct owl_ref r = ref; !r.empty; r = owl_next(r)) {
-        arguments.push_back(compile_expression(r));
+        const ConstExpression_ptr argument = compile_expression(r);
+        arguments.push_back(bytecode ? BytecodeExpression::create(argument) : argument);
     }
     return arguments;
 }
 
-Expression_ptr compile_expression(const struct owl_ref ref) {
+ConstExpression_ptr compile_expression(const struct owl_ref ref) {
     const struct parsed_expression expression = parsed_expression_get(ref);
     switch (expression.type) {
     case PARSED_TRUE:
@@ -68,10 +75,14 @@ Expression_ptr compile_expression(const struct owl_ref ref) {
         const struct parsed_string string = parsed_string_get(expression.string);
         return std::make_shared<StringExpression>(std::string(string.string, string.length));
     }
-    case PARSED_INTEGER:
-        return std::make_shared<IntegerExpression>(parsed_integer_get(expression.integer).integer);
-    case PARSED_NUMBER:
-        return std::make_shared<NumberExpression>(parsed_number_get(expression.number).number);
+    case PARSED_INTEGER: {
+        const struct parsed_integer integer = parsed_integer_get(expression.integer);
+        return StatementCache::literal(integer.range.start, std::make_shared<IntegerExpression>(integer.integer));
+    }
+    case PARSED_NUMBER: {
+        const struct parsed_number number = parsed_number_get(expression.number);
+        return StatementCache::literal(number.range.start, std::make_shared<NumberExpression>(number.number));
+    }
     case PARSED_VARIABLE:
         return std::make_shared<VariableExpression>(Global::get_variable(identifier_to_string(expression.identifier)));
     case PARSED_PROPERTY:
@@ -80,49 +91,49 @@ Expression_ptr compile_expression(const struct owl_ref ref) {
     case PARSED_PARENTHESES:
         return compile_expression(expression.expression);
     case PARSED_POWER:
-        return std::make_shared<PowerExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::power(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_NEGATE:
-        return std::make_shared<NegateExpression>(compile_expression(expression.operand));
+        return Optimizer::negate(compile_expression(expression.operand));
     case PARSED_MULTIPLY:
-        return std::make_shared<MultiplyExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::multiply(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_DIVIDE:
-        return std::make_shared<DivideExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::division<DivideExpression>(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_MODULO:
-        return std::make_shared<ModuloExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::division<ModuloExpression>(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_FLOOR_DIVIDE:
-        return std::make_shared<FloorDivideExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::division<FloorDivideExpression>(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_ADD:
-        return std::make_shared<AddExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::binary<AddExpression>(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_SUBTRACT:
-        return std::make_shared<SubtractExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::binary<SubtractExpression>(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_SHIFT_LEFT:
-        return std::make_shared<ShiftLeftExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::binary<ShiftLeftExpression>(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_SHIFT_RIGHT:
-        return std::make_shared<ShiftRightExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::binary<ShiftRightExpression>(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_BIT_AND:
-        return std::make_shared<BitAndExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::binary<BitAndExpression>(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_BIT_XOR:
-        return std::make_shared<BitXorExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::binary<BitXorExpression>(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_BIT_OR:
-        return std::make_shared<BitOrExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::binary<BitOrExpression>(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_GREATER:
-        return std::make_shared<GreaterExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::binary<GreaterExpression>(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_LESS:
-        return std::make_shared<LessExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::binary<LessExpression>(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_GREATER_EQUAL:
-        return std::make_shared<GreaterEqualExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::binary<GreaterEqualExpression>(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_LESS_EQUAL:
-        return std::make_shared<LessEqualExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::binary<LessEqualExpression>(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_EQUAL:
-        return std::make_shared<EqualExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::binary<EqualExpression>(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_UNEQUAL:
-        return std::make_shared<UnequalExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::binary<UnequalExpression>(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_NOT:
-        return std::make_shared<NotExpression>(compile_expression(expression.operand));
+        return Optimizer::unary<NotExpression>(compile_expression(expression.operand));
     case PARSED_AND:
-        return std::make_shared<AndExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::logical_and(compile_expression(expression.left), compile_expression(expression.right));
     case PARSED_OR:
-        return std::make_shared<OrExpression>(compile_expression(expression.left), compile_expression(expression.right));
+        return Optimizer::logical_or(compile_expression(expression.left), compile_expression(expression.right));
     default:
         throw std::runtime_error("invalid expression");
     }
@@ -138,8 +149,9 @@ std::vector<Action_ptr> compile_actions(const struct owl_ref ref) {
             const std::string module_name = identifier_to_string(method_call.module_name);
             const Module_ptr module = Global::get_module(module_name);
             const std::string method_name = identifier_to_string(method_call.method_name);
-            const std::vector<ConstExpression_ptr> arguments = compile_arguments(method_call.argument);
-            actions.push_back(std::make_shared<MethodCall>(module, method_name, arguments));
+            const std::vector<ConstExpression_ptr> arguments = compile_arguments(method_call.argument, true);
+            const unsigned int method_id = module->find_method(method_name, arguments);
+            actions.push_back(std::make_shared<MethodCall>(module, method_id, arguments));
         } else if (!action.routine_call.empty) {
             const struct parsed_routine_call routine_call = parsed_routine_call_get(action.routine_call);
             const std::string routine_name = identifier_to_string(routine_call.routine_name);
@@ -150,13 +162,13 @@ std::vector<Action_ptr> compile_actions(const struct owl_ref ref) {
             const std::string module_name = identifier_to_string(property_assignment.module_name);
             const Module_ptr module = Global::get_module(module_name);
             const std::string property_name = identifier_to_string(property_assignment.property_name);
-            const ConstExpression_ptr expression = compile_expression(property_assignment.expression);
+            const ConstExpression_ptr expression = BytecodeExpression::create(compile_expression(property_assignment.expression));
             actions.push_back(std::make_shared<PropertyAssignment>(module, property_name, expression));
         } else if (!action.variable_assignment.empty) {
             const struct parsed_variable_assignment variable_assignment = parsed_variable_assignment_get(action.variable_assignment);
             const std::string variable_name = identifier_to_string(variable_assignment.variable_name);
             const Variable_ptr variable = Global::get_variable(variable_name);
-            const ConstExpression_ptr expression = compile_expression(variable_assignment.expression);
+            const ConstExpression_ptr expression = BytecodeExpression::create(compile_expression(variable_assignment.expression));
             if (variable->type != expression->type) {
                 throw std::runtime_error("type mismatch for variable assignment");
             }
@@ -182,6 +194,7 @@ std::vector<Action_ptr> compile_actions(const struct owl_ref ref) {
 
 void process_tree(owl_tree *const tree, bool from_expander) {
     const struct parsed_statements statements = owl_tree_get_parsed_statements(tree);
+    const bool is_single_statement = owl_next(statements.statement).empty;
     for (struct owl_ref r = statements.statement; !r.empty; r = owl_next(r)) {
         const struct parsed_statement statement = parsed_statement_get(r);
         if (!statement.noop.empty) {
@@ -215,12 +228,18 @@ void process_tree(owl_tree *const tree, bool from_expander) {
                 Global::add_module(module_name, proxy);
             }
         } else if (!statement.method_call.empty) {
+            if (is_single_statement) {
+                StatementCache::record();
+            }
             const struct parsed_method_call method_call = parsed_method_call_get(statement.method_call);
             const std::string module_name = identifier_to_string(method_call.module_name);
             const Module_ptr module = Global::get_module(module_name);
             const std::string method_name = identifier_to_string(method_call.method_name);
             const std::vector<ConstExpression_ptr> arguments = compile_arguments(method_call.argument);
-            module->call_with_shadows(method_name, arguments);
+            const unsigned int method_id = module->find_method(method_name, arguments);
+            const Action_ptr action = std::make_shared<MethodCall>(module, method_id, arguments);
+            StatementCache::insert(action);
+            action->run();
         } else if (!statement.routine_call.empty) {
             const struct parsed_routine_call routine_call = parsed_routine_call_get(statement.routine_call);
             const std::string routine_name = identifier_to_string(routine_call.routine_name);
@@ -230,12 +249,17 @@ void process_tree(owl_tree *const tree, bool from_expander) {
             }
             routine->start();
         } else if (!statement.property_assignment.empty) {
+            if (is_single_statement) {
+                StatementCache::record();
+            }
             const struct parsed_property_assignment property_assignment = parsed_property_assignment_get(statement.property_assignment);
             const std::string module_name = identifier_to_string(property_assignment.module_name);
             const Module_ptr module = Global::get_module(module_name);
             const std::string property_name = identifier_to_string(property_assignment.property_name);
             const ConstExpression_ptr expression = compile_expression(property_assignment.expression);
-            module->write_property(property_name, expression, from_expander);
+            const Action_ptr action = std::make_shared<PropertyAssignment>(module, property_name, expression, from_expander);
+            StatementCache::insert(action);
+            action->run();
         } else if (!statement.variable_assignment.empty) {
             const struct parsed_variable_assignment variable_assignment = parsed_variable_assignment_get(statement.variable_assignment);
             const std::string variable_name = identifier_to_string(variable_assignment.variable_name);
@@ -278,6 +302,7 @@ void process_tree(owl_tree *const tree, bool from_expander) {
             const struct parsed_rule_definition rule_definition = parsed_rule_definition_get(statement.rule_definition);
             const struct parsed_actions actions = parsed_actions_get(rule_definition.actions);
             const Routine_ptr routine = std::make_shared<Routine>(compile_actions(actions.action));
+            // conditions are mostly short comparisons, which the tree evaluates faster than the bytecode
             const ConstExpression_ptr condition = compile_expression(rule_definition.condition);
             Global::add_rule(std::make_shared<Rule>(condition, routine));
         } else {
@@ -296,6 +321,12 @@ void process_lizard(const char *line, bool trigger_keep_alive, bool from_expande
         echo(">> %s", line);
         tic();
     }
+    if (StatementCache::run(line, from_expander)) {
+        if (debug) {
+            toc("Cached statement");
+        }
+        return;
+    }
     auto const tree = std::unique_ptr<owl_tree, std::function<void(owl_tree *)>>(owl_tree_create_from_string(line), owl_tree_destroy);
     if (debug) {
         toc("Tree creation");
@@ -324,9 +355,11 @@ void process_lizard(const char *line, bool trigger_keep_alive, bool from_expande
             owl_tree_print(tree.get());
             tic();
         }
+        Optimizer::eliminated_nodes = 0;
         process_tree(tree.get(), from_expander);
         if (debug) {
             toc("Tree traversal");
+            echo("Optimization eliminated %u nodes", Optimizer::eliminated_nodes);
         }
     }
 }
@@ -360,16 +393,63 @@ void process_line(const char *line, const int len) {
     }
 }
 
+QueueHandle_t uart_event_queue;
+SpscQueue<std::string> uart_lines(16);
+
+void uart_reader_task(void *arg) {
+    const TaskHandle_t main_task = static_cast<TaskHandle_t>(arg);
+    static char buffer[BUFFER_SIZE];
+    uart_event_t event;
+    while (true) {
+        if (xQueueReceive(uart_event_queue, &event, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        if (event.type == UART_FIFO_OVF || event.type == UART_BUFFER_FULL) {
+            uart_flush_input(UART_NUM_0);
+            xQueueReset(uart_event_queue);
+            continue;
+        }
+        if (event.type != UART_PATTERN_DET) {
+            continue;
+        }
+        while (true) {
+            const int pos = uart_pattern_pop_pos(UART_NUM_0);
+            if (pos < 0) {
+                break;
+            }
+            if (pos >= BUFFER_SIZE) {
+                for (int rest = pos + 1; rest > 0;) {
+                    const int len = uart_read_bytes(UART_NUM_0, (uint8_t *)buffer, std::min(rest, BUFFER_SIZE), 0);
+                    if (len <= 0) {
+                        break;
+                    }
+                    rest -= len;
+                }
+                continue;
+            }
+            const int len = uart_read_bytes(UART_NUM_0, (uint8_t *)buffer, pos + 1, 0);
+            if (len <= 0) {
+                continue;
+            }
+            while (!uart_lines.push(std::string(buffer, len))) {
+                vTaskDelay(1);
+            }
+            xTaskNotify(main_task, MAIN_TASK_UART_BIT, eSetBits);
+        }
+    }
+}
+
 void process_uart() {
     static char input[BUFFER_SIZE];
-    while (true) {
-        int pos = uart_pattern_pop_pos(UART_NUM_0);
-        if (pos < 0) {
-            break;
+    std::string line;
+    while (uart_lines.pop(line)) {
+        try {
+            memcpy(input, line.data(), line.size());
+            const int len = check(input, line.size());
+            process_line(input, len);
+        } catch (const std::runtime_error &e) {
+            echo("error processing uart0: %s", e.what());
         }
-        int len = uart_read_bytes(UART_NUM_0, (uint8_t *)input, pos + 1, 0);
-        len = check(input, len);
-        process_line(input, len);
     }
 }
 
@@ -383,7 +463,7 @@ void run_step(Module_ptr module) {
 
 void app_main() {
     const uart_config_t uart_config = {
-        .baud_rate = 115200,
+        .baud_rate = CONFIG_LIZARD_BAUD_RATE,
         .data_bits = UART_DATA_8_BITS,
         .parity = UART_PARITY_DISABLE,
         .stop_bits = UART_STOP_BITS_1,
@@ -392,11 +472,17 @@ void app_main() {
         .use_ref_tick = false,
     };
     uart_param_config(UART_NUM_0, &uart_config);
-    uart_driver_install(UART_NUM_0, BUFFER_SIZE * 2, 0, 0, NULL, 0);
+    uart_driver_install(UART_NUM_0, BUFFER_SIZE * 2, 0, 20, &uart_event_queue, 0);
     uart_enable_pattern_det_baud_intr(UART_NUM_0, '\n', 1, 9, 0, 0);
     uart_pattern_queue_reset(UART_NUM_0, 100);
 
-    printf("\nReady.\n");
+    try {
+        start_output_task();
+    } catch (const std::runtime_error &e) {
+        echo("error while starting output task: %s", e.what());
+    }
+
+    write_message("\nReady.\n");
 
     try {
         Global::add_module("core", core_module = std::make_shared<Core>("core"));
@@ -418,15 +504,26 @@ void app_main() {
         echo("error while verifying OTA: %s", e.what());
     }
 
-    while (true) {
-        try {
-            process_uart();
-        } catch (const std::runtime_error &e) {
-            echo("error processing uart0: %s", e.what());
+    try {
+#ifdef CONFIG_LIZARD_BUS_IO_TASKS
+        start_io_task(uart_reader_task, "uart_reader", xTaskGetCurrentTaskHandle());
+#else
+        if (xTaskCreate(uart_reader_task, "uart_reader", 4096, xTaskGetCurrentTaskHandle(), 5, NULL) != pdPASS) {
+            throw std::runtime_error("could not start uart_reader task");
         }
+#endif
+    } catch (const std::runtime_error &e) {
+        echo("error while starting uart reader: %s", e.what());
+        exit(1);
+    }
+
+    while (true) {
+        process_uart();
 
+        const unsigned int cycle = core_module->get_cycle();
+        const number_t loop_rate = core_module->get_rate();
         for (auto const &[module_name, module] : Global::modules) {
-            if (module != core_module) {
+            if (module != core_module && module->is_due(cycle, loop_rate)) {
                 run_step(module);
             }
         }
@@ -434,7 +531,7 @@ void app_main() {
 
         for (auto const &rule : Global::rules) {
             try {
-                if (rule->condition->evaluate_boolean() && !rule->routine->is_running()) {
+                if (rule->evaluate_condition() && !rule->routine->is_running()) {
                     rule->routine->start();
                 }
                 rule->routine->step();
@@ -451,6 +548,11 @@ void app_main() {
             }
         }
 
-        delay(10);
+        // watches report changes made by rules and routines in the same cycle
+        core_module->check_watches();
+
+        while (!core_module->wait_for_next_cycle()) {
+            process_uart();
+        }
     }
 }
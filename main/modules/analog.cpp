@@ -3,6 +3,15 @@
 #include "freertos/task.h"
 #include "uart.h"
 
+const std::vector<Property> Analog::property_table = create_property_table<PropertyId::count>({
+    {"raw", integer},
+    {"voltage", number},
+});
+
+const std::vector<Property> &Analog::get_property_table() const {
+    return Analog::property_table;
+}
+
 Analog::Analog(const std::string name, uint8_t unit, uint8_t channel, float attenuation_level)
     : Module(analog, name), unit(unit) {
     if (unit < 1 || unit > 2) {
@@ -39,8 +48,7 @@ Analog::Analog(const std::string name, uint8_t unit, uint8_t channel, float atte
         esp_adc_cal_characterize(ADC_UNIT_2, attenuation, ADC_WIDTH_BIT_12, 1100, &this->characteristics);
     }
 
-    this->properties["raw"] = std::make_shared<IntegerVariable>();
-    this->properties["voltage"] = std::make_shared<NumberVariable>();
+    this->create_properties();
 }
 
 void Analog::step() {
@@ -51,8 +59,8 @@ void Analog::step() {
         adc2_get_raw(static_cast<adc2_channel_t>(this->channel), ADC_WIDTH_BIT_12, &reading);
     }
 
-    this->properties.at("raw")->integer_value = reading;
-    this->properties.at("voltage")->number_value = 0.001 * esp_adc_cal_raw_to_voltage(reading, &this->characteristics);
+    this->property(PropertyId::raw)->set_integer(reading);
+    this->property(PropertyId::voltage)->set_number(0.001 * esp_adc_cal_raw_to_voltage(reading, &this->characteristics));
 
     Module::step();
 }
@@ -8,11 +8,18 @@ using Analog_ptr = std::shared_ptr<Analog>;
 
 class Analog : public Module {
 private:
+    enum class PropertyId : unsigned int {
+        raw,
+        voltage,
+        count,
+    };
+    static const std::vector<Property> property_table;
     uint8_t unit = 0;
     uint8_t channel = 0;
     esp_adc_cal_characteristics_t characteristics;
 
 public:
     Analog(const std::string name, uint8_t unit, uint8_t channel, float attenuation_level);
+    const std::vector<Property> &get_property_table() const override;
     void step() override;
 };
@@ -13,11 +13,20 @@ Bluetooth::Bluetooth(const std::string name, const std::string device_name, Mess
     });
 }
 
-void Bluetooth::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (method_name == "send") {
-        expect(arguments, 1, string);
+const std::vector<Method> Bluetooth::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"send", {string}},
+});
+
+const std::vector<Method> &Bluetooth::get_methods() const {
+    return Bluetooth::methods;
+}
+
+void Bluetooth::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::send:
         ZZ::BleCommand::send(arguments[0]->evaluate_string());
-    } else {
-        Module::call(method_name, arguments);
+        break;
+    default:
+        Module::call(method_id, arguments);
     }
 }
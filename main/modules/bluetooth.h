@@ -10,10 +10,16 @@ using ConstBluetooth_ptr = std::shared_ptr<const Bluetooth>;
 
 class Bluetooth : public Module {
 private:
+    enum class MethodId : unsigned int {
+        send = Module::method_count,
+        count,
+    };
+    static const std::vector<Method> methods;
     const std::string device_name;
 
 public:
     Bluetooth(const std::string name, const std::string device_name, MessageHandler message_handler);
 
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
 };
@@ -1,61 +1,181 @@
 #include "can.h"
+#include "../utils/io_task.h"
 #include "../utils/uart.h"
-#include "driver/twai.h"
+#include <algorithm>
 
-Can::Can(const std::string name, const gpio_num_t rx_pin, const gpio_num_t tx_pin, const long baud_rate)
-    : Module(can, name) {
-    twai_general_config_t g_config = TWAI_GENERAL_CONFIG_DEFAULT(tx_pin, rx_pin, TWAI_MODE_NORMAL);
-    twai_timing_config_t t_config;
-    twai_filter_config_t f_config = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+#define CAN_RX_TASK_PRIORITY (IO_TASK_PRIORITY + 5)
+
+#define CAN_TX_DRIVER_QUEUE_MICROS 10000
+#define CAN_TX_DRIVER_QUEUE_MIN_LENGTH 2
+#define CAN_TX_DRIVER_QUEUE_MAX_LENGTH 16
+#define CAN_FRAME_BITS 130
+#define CAN_TX_QUEUE_LENGTH 32
+
+const std::vector<Property> Can::property_table = create_property_table<PropertyId::count>({
+    {"state", string},
+    {"tx_error_counter", integer},
+    {"rx_error_counter", integer},
+    {"msgs_to_tx", integer},
+    {"msgs_to_rx", integer},
+    {"tx_failed_count", integer},
+    {"rx_missed_count", integer},
+    {"rx_overrun_count", integer},
+    {"arb_lost_count", integer},
+    {"bus_error_count", integer},
+    {"rx_dispatched", integer},
+    {"rx_unsubscribed", integer},
+    {"tx_pending", integer},
+    {"tx_coalesced", integer},
+    {"tx_dropped", integer},
+    {"tx_latency_max", integer},
+});
 
+const std::vector<Property> &Can::get_property_table() const {
+    return Can::property_table;
+}
+
+Can::Can(const std::string name, const gpio_num_t rx_pin, const gpio_num_t tx_pin, const long baud_rate)
+    : Module(can, name), g_config(TWAI_GENERAL_CONFIG_DEFAULT(tx_pin, rx_pin, TWAI_MODE_NORMAL)) {
     switch (baud_rate) {
     case 1000000:
-        t_config = TWAI_TIMING_CONFIG_1MBITS();
+        this->t_config = TWAI_TIMING_CONFIG_1MBITS();
         break;
     case 800000:
-        t_config = TWAI_TIMING_CONFIG_800KBITS();
+        this->t_config = TWAI_TIMING_CONFIG_800KBITS();
         break;
     case 500000:
-        t_config = TWAI_TIMING_CONFIG_500KBITS();
+        this->t_config = TWAI_TIMING_CONFIG_500KBITS();
         break;
     case 250000:
-        t_config = TWAI_TIMING_CONFIG_250KBITS();
+        this->t_config = TWAI_TIMING_CONFIG_250KBITS();
         break;
     case 125000:
-        t_config = TWAI_TIMING_CONFIG_125KBITS();
+        this->t_config = TWAI_TIMING_CONFIG_125KBITS();
         break;
     case 100000:
-        t_config = TWAI_TIMING_CONFIG_100KBITS();
+        this->t_config = TWAI_TIMING_CONFIG_100KBITS();
         break;
     case 50000:
-        t_config = TWAI_TIMING_CONFIG_50KBITS();
+        this->t_config = TWAI_TIMING_CONFIG_50KBITS();
         break;
     case 25000:
-        t_config = TWAI_TIMING_CONFIG_25KBITS();
+        this->t_config = TWAI_TIMING_CONFIG_25KBITS();
         break;
     default:
         throw std::runtime_error("invalid baud rate");
     }
 
-    g_config.rx_queue_len = 20;
-    g_config.tx_queue_len = 20;
+    this->g_config.rx_queue_len = CONFIG_LIZARD_CAN_RX_QUEUE_LENGTH;
+    const long frames_per_cycle = baud_rate / CAN_FRAME_BITS * CAN_TX_DRIVER_QUEUE_MICROS / 1000000;
+    this->g_config.tx_queue_len = std::min(std::max(frames_per_cycle, (long)CAN_TX_DRIVER_QUEUE_MIN_LENGTH),
+                                           (long)CAN_TX_DRIVER_QUEUE_MAX_LENGTH);
 
-    this->properties["state"] = std::make_shared<StringVariable>();
-    this->properties["tx_error_counter"] = std::make_shared<IntegerVariable>();
-    this->properties["rx_error_counter"] = std::make_shared<IntegerVariable>();
-    this->properties["msgs_to_tx"] = std::make_shared<IntegerVariable>();
-    this->properties["msgs_to_rx"] = std::make_shared<IntegerVariable>();
-    this->properties["tx_failed_count"] = std::make_shared<IntegerVariable>();
-    this->properties["rx_missed_count"] = std::make_shared<IntegerVariable>();
-    this->properties["rx_overrun_count"] = std::make_shared<IntegerVariable>();
-    this->properties["arb_lost_count"] = std::make_shared<IntegerVariable>();
-    this->properties["bus_error_count"] = std::make_shared<IntegerVariable>();
+    this->create_properties();
 
-    ESP_ERROR_CHECK(twai_driver_install(&g_config, &t_config, &f_config));
+    ESP_ERROR_CHECK(twai_driver_install(&this->g_config, &this->t_config, &this->f_config));
     ESP_ERROR_CHECK(twai_start());
 }
 
+twai_filter_config_t Can::compute_filter() const {
+    std::vector<uint32_t> ids;
+    for (uint32_t id = 0; id <= TWAI_STD_ID_MASK; ++id) {
+        if (this->standard_dispatch_table[id]) {
+            ids.push_back(id);
+        }
+    }
+    if (ids.empty() || !this->extended_dispatch_map.empty() || this->output_on) {
+        return TWAI_FILTER_CONFIG_ACCEPT_ALL();
+    }
+    const auto dont_care_bits = [&ids](const size_t begin, const size_t end) {
+        uint32_t all = TWAI_STD_ID_MASK;
+        uint32_t any = 0;
+        for (size_t i = begin; i < end; ++i) {
+            all &= ids[i];
+            any |= ids[i];
+        }
+        return all ^ any;
+    };
+    const auto accepted_count = [](const uint32_t dont_care) {
+        return 1U << __builtin_popcount(dont_care);
+    };
+
+    const uint32_t single_dont_care = dont_care_bits(0, ids.size());
+    size_t best_split = 0;
+    unsigned int best_count = accepted_count(single_dont_care);
+    for (size_t split = 1; split < ids.size(); ++split) {
+        const unsigned int count = accepted_count(dont_care_bits(0, split)) + accepted_count(dont_care_bits(split, ids.size()));
+        if (count < best_count) {
+            best_count = count;
+            best_split = split;
+        }
+    }
+    twai_filter_config_t filter = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+    if (best_split == 0) {
+        filter.acceptance_code = ids[0] << 21;
+        filter.acceptance_mask = (single_dont_care << 21) | 0x1fffff;
+        filter.single_filter = true;
+    } else {
+        filter.acceptance_code = (ids[0] << 21) | (ids[best_split] << 5);
+        filter.acceptance_mask = (dont_care_bits(0, best_split) << 21) | 0x1f0000 | (dont_care_bits(best_split, ids.size()) << 5) | 0x1f;
+        filter.single_filter = false;
+    }
+    return filter;
+}
+
+void Can::update_filter() {
+    const twai_filter_config_t filter = this->compute_filter();
+    this->is_filter_dirty = false;
+    this->is_filter_for_output = this->output_on;
+    if (filter.acceptance_code == this->f_config.acceptance_code &&
+        filter.acceptance_mask == this->f_config.acceptance_mask &&
+        filter.single_filter == this->f_config.single_filter) {
+        return;
+    }
+
+#ifdef CONFIG_LIZARD_BUS_IO_TASKS
+    if (this->rx_task) {
+        this->is_rx_pause_requested = true;
+        while (!this->is_rx_paused) {
+            vTaskDelay(1);
+        }
+    }
+#endif
+    twai_status_info_t status_info;
+    const bool was_stopped = twai_get_status_info(&status_info) == ESP_OK && status_info.state == TWAI_STATE_STOPPED;
+    twai_stop();
+    const char *error = nullptr;
+    if (twai_driver_uninstall() != ESP_OK) {
+        error = "could not uninstall twai driver to update the acceptance filter";
+    } else if (twai_driver_install(&this->g_config, &this->t_config, &filter) != ESP_OK) {
+        error = "could not reinstall twai driver with updated acceptance filter";
+    } else if (!was_stopped && twai_start() != ESP_OK) {
+        error = "could not restart twai driver with updated acceptance filter";
+    }
+    if (!error) {
+        this->f_config = filter;
+    }
+#ifdef CONFIG_LIZARD_BUS_IO_TASKS
+    this->is_rx_pause_requested = false;
+    while (this->rx_task && this->is_rx_paused) {
+        vTaskDelay(1);
+    }
+#endif
+    if (error) {
+        throw std::runtime_error(error);
+    }
+}
+
 void Can::step() {
+    if (this->is_filter_dirty || this->output_on != this->is_filter_for_output) {
+        this->update_filter();
+    }
+#ifdef CONFIG_LIZARD_BUS_IO_TASKS
+    if (!this->rx_task) {
+        this->rx_task = start_io_task(Can::run_rx_task, "can_rx", this, CAN_RX_TASK_PRIORITY);
+    }
+#endif
+
+    this->flush_tx();
     while (this->receive()) {
     }
 
@@ -63,35 +183,90 @@ void Can::step() {
     if (twai_get_status_info(&status_info) != ESP_OK) {
         throw std::runtime_error("could not get status info");
     }
-    this->properties.at("state")->string_value = status_info.state == TWAI_STATE_STOPPED      ? "STOPPED"
-                                                 : status_info.state == TWAI_STATE_RUNNING    ? "RUNNING"
-                                                 : status_info.state == TWAI_STATE_BUS_OFF    ? "BUS_OFF"
-                                                 : status_info.state == TWAI_STATE_RECOVERING ? "RECOVERING"
-                                                                                              : "UNKNOWN";
-    this->properties.at("tx_error_counter")->integer_value = status_info.tx_error_counter;
-    this->properties.at("rx_error_counter")->integer_value = status_info.rx_error_counter;
-    this->properties.at("msgs_to_tx")->integer_value = status_info.msgs_to_tx;
-    this->properties.at("msgs_to_rx")->integer_value = status_info.msgs_to_rx;
-    this->properties.at("tx_failed_count")->integer_value = status_info.tx_failed_count;
-    this->properties.at("rx_missed_count")->integer_value = status_info.rx_missed_count;
-    this->properties.at("rx_overrun_count")->integer_value = status_info.rx_overrun_count;
-    this->properties.at("arb_lost_count")->integer_value = status_info.arb_lost_count;
-    this->properties.at("bus_error_count")->integer_value = status_info.bus_error_count;
+    this->property(PropertyId::state)->set_string(status_info.state == TWAI_STATE_STOPPED      ? "STOPPED"
+                                             : status_info.state == TWAI_STATE_RUNNING    ? "RUNNING"
+                                             : status_info.state == TWAI_STATE_BUS_OFF    ? "BUS_OFF"
+                                             : status_info.state == TWAI_STATE_RECOVERING ? "RECOVERING"
+                                                                                          : "UNKNOWN");
+    this->property(PropertyId::tx_error_counter)->set_integer(status_info.tx_error_counter);
+    this->property(PropertyId::rx_error_counter)->set_integer(status_info.rx_error_counter);
+    this->property(PropertyId::msgs_to_tx)->set_integer(status_info.msgs_to_tx);
+    this->property(PropertyId::msgs_to_rx)->set_integer(status_info.msgs_to_rx);
+    this->property(PropertyId::tx_failed_count)->set_integer(status_info.tx_failed_count);
+    this->property(PropertyId::rx_missed_count)->set_integer(status_info.rx_missed_count);
+    this->property(PropertyId::rx_overrun_count)->set_integer(status_info.rx_overrun_count);
+    this->property(PropertyId::arb_lost_count)->set_integer(status_info.arb_lost_count);
+    this->property(PropertyId::bus_error_count)->set_integer(status_info.bus_error_count);
+    this->property(PropertyId::rx_dispatched)->set_integer(this->rx_dispatched_count);
+    this->property(PropertyId::rx_unsubscribed)->set_integer(this->rx_unsubscribed_count);
+    this->property(PropertyId::tx_pending)->set_integer(this->count_pending_tx());
+    this->property(PropertyId::tx_coalesced)->set_integer(this->tx_coalesced_count);
+    this->property(PropertyId::tx_dropped)->set_integer(this->tx_dropped_count);
+    this->property(PropertyId::tx_latency_max)->set_integer(this->tx_latency_max);
+    this->tx_latency_max = 0;
 
     Module::step();
 }
 
+#ifdef CONFIG_LIZARD_BUS_IO_TASKS
+void Can::run_rx_task(void *arg) {
+    Can *const can = static_cast<Can *>(arg);
+    frame_t frame;
+    while (true) {
+        if (can->is_rx_pause_requested) {
+            can->is_rx_paused = true;
+            while (can->is_rx_pause_requested) {
+                vTaskDelay(1);
+            }
+            can->is_rx_paused = false;
+        }
+        if (twai_receive(&frame.message, pdMS_TO_TICKS(10)) != ESP_OK) {
+            continue;
+        }
+        frame.timestamp = esp_timer_get_time();
+        while (!can->rx_queue.push(frame) && !can->is_rx_pause_requested) {
+            vTaskDelay(1);
+        }
+    }
+}
+#endif
+
+bool Can::pop_frame(frame_t &frame) {
+#ifdef CONFIG_LIZARD_BUS_IO_TASKS
+    if (this->rx_task) {
+        return this->rx_queue.pop(frame);
+    }
+#endif
+    if (twai_receive(&frame.message, pdMS_TO_TICKS(0)) != ESP_OK) {
+        return false;
+    }
+    frame.timestamp = esp_timer_get_time();
+    return true;
+}
+
 bool Can::receive() {
-    twai_message_t message;
-    if (twai_receive(&message, pdMS_TO_TICKS(0)) != ESP_OK) {
+    frame_t frame;
+    if (!this->pop_frame(frame)) {
         return false;
     }
+    const twai_message_t &message = frame.message;
+    this->rx_timestamp = frame.timestamp;
 
-    if (this->subscribers.count(message.identifier)) {
-        this->subscribers[message.identifier]->handle_can_msg(
+    uint8_t index = 0;
+    if (!(message.flags & TWAI_MSG_FLAG_EXTD)) {
+        index = this->standard_dispatch_table[message.identifier & TWAI_STD_ID_MASK];
+    } else if (!this->extended_dispatch_map.empty()) {
+        const auto it = this->extended_dispatch_map.find(message.identifier);
+        index = it == this->extended_dispatch_map.end() ? 0 : it->second;
+    }
+    if (index) {
+        this->rx_dispatched_count++;
+        this->subscribers[index - 1]->handle_can_msg(
             message.identifier,
             message.data_length_code,
             message.data);
+    } else {
+        this->rx_unsubscribed_count++;
     }
 
     if (this->output_on) {
@@ -102,39 +277,126 @@ bool Can::receive() {
                 pos += std::sprintf(&buffer[pos], ",%02x", message.data[i]);
             }
         }
-        echo(buffer);
+        echo_telemetry(buffer);
     }
 
     return true;
 }
 
-void Can::send(const uint32_t id, const uint8_t data[8], const bool rtr, uint8_t dlc) const {
-    twai_message_t message;
-    message.identifier = id;
-    message.flags = rtr ? TWAI_MSG_FLAG_RTR : TWAI_MSG_FLAG_NONE;
-    message.data_length_code = dlc;
+void Can::send(const uint32_t id, const uint8_t data[8], const bool rtr, uint8_t dlc, const CanTxPriority priority,
+               const uint32_t id_base) {
+    tx_frame_t frame;
+    frame.message.identifier = id;
+    frame.message.flags = rtr ? TWAI_MSG_FLAG_RTR : TWAI_MSG_FLAG_NONE;
+    frame.message.data_length_code = dlc;
     for (int i = 0; i < dlc; ++i) {
-        message.data[i] = data[i];
+        frame.message.data[i] = data[i];
     }
-    if (twai_transmit(&message, pdMS_TO_TICKS(0)) != ESP_OK) {
-        if (twai_stop() != ESP_OK || twai_start() != ESP_OK) {
-            throw std::runtime_error("could not send CAN message and could not restart twai driver");
+    frame.timestamp = esp_timer_get_time();
+    frame.id_base = id_base == CAN_NO_ID_BASE ? id : id_base;
+    frame.priority = priority;
+
+    // frames to the same device must not overtake each other, so a frame waits behind a pending one of a lower priority
+    int queue_priority = priority;
+    if (priority != can_tx_emergency) {
+        const auto has_same_base = [&frame](const tx_frame_t &queued) { return queued.id_base == frame.id_base; };
+        for (int lower_priority = can_tx_config; lower_priority > priority; --lower_priority) {
+            const std::deque<tx_frame_t> &lower_queue = this->tx_queues[lower_priority];
+            if (std::any_of(lower_queue.begin(), lower_queue.end(), has_same_base)) {
+                queue_priority = lower_priority;
+                break;
+            }
+        }
+    }
+
+    std::deque<tx_frame_t> &queue = this->tx_queues[queue_priority];
+    bool is_coalesced = false;
+    if (priority == can_tx_setpoint) {
+        for (auto queued = queue.rbegin(); queued != queue.rend(); ++queued) {
+            if (queued->id_base != frame.id_base) {
+                continue;
+            }
+            if (queued->priority != can_tx_setpoint) {
+                break;
+            }
+            if (queued->message.identifier == id && queued->message.flags == frame.message.flags) {
+                queued->message = frame.message;
+                this->tx_coalesced_count++;
+                is_coalesced = true;
+                break;
+            }
         }
-        throw std::runtime_error("could not send CAN message");
     }
+    if (!is_coalesced) {
+        if (queue.size() < CAN_TX_QUEUE_LENGTH) {
+            queue.push_back(frame);
+        } else {
+            this->tx_dropped_count++;
+        }
+    }
+    this->flush_tx();
 }
 
 void Can::send(uint32_t id,
                uint8_t d0, uint8_t d1, uint8_t d2, uint8_t d3,
                uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7,
-               bool rtr) const {
+               bool rtr, const CanTxPriority priority, const uint32_t id_base) {
     uint8_t data[8] = {d0, d1, d2, d3, d4, d5, d6, d7};
-    this->send(id, data, rtr);
+    this->send(id, data, rtr, 8, priority, id_base);
+}
+
+void Can::flush_tx() {
+    for (std::deque<tx_frame_t> &queue : this->tx_queues) {
+        while (!queue.empty()) {
+            const esp_err_t result = twai_transmit(&queue.front().message, pdMS_TO_TICKS(0));
+            if (result == ESP_ERR_INVALID_STATE) {
+                // syncs, setpoints and config frames would be stale after a recovery, but stop commands are kept
+                for (int priority = can_tx_sync; priority <= can_tx_config; ++priority) {
+                    this->tx_dropped_count += this->tx_queues[priority].size();
+                    this->tx_queues[priority].clear();
+                }
+                return;
+            }
+            if (result != ESP_OK) {
+                return;
+            }
+            this->tx_latency_max = std::max(this->tx_latency_max, esp_timer_get_time() - queue.front().timestamp);
+            queue.pop_front();
+        }
+    }
+}
+
+void Can::discard_tx(const uint32_t id) {
+    for (int priority = can_tx_sync; priority <= can_tx_config; ++priority) {
+        std::deque<tx_frame_t> &queue = this->tx_queues[priority];
+        queue.erase(std::remove_if(queue.begin(), queue.end(), [id](const tx_frame_t &frame) { return frame.message.identifier == id; }),
+                    queue.end());
+    }
+}
+
+size_t Can::count_pending_tx() const {
+    size_t count = 0;
+    for (const std::deque<tx_frame_t> &queue : this->tx_queues) {
+        count += queue.size();
+    }
+    return count;
 }
 
-void Can::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (method_name == "send") {
-        Module::expect(arguments, 9, integer, integer, integer, integer, integer, integer, integer, integer, integer);
+const std::vector<Method> Can::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"send", {integer, integer, integer, integer, integer, integer, integer, integer, integer}},
+    {"status"},
+    {"start"},
+    {"stop"},
+    {"recover"},
+});
+
+const std::vector<Method> &Can::get_methods() const {
+    return Can::methods;
+}
+
+void Can::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::send:
         this->send(arguments[0]->evaluate_integer(),
                    arguments[1]->evaluate_integer(),
                    arguments[2]->evaluate_integer(),
@@ -144,41 +406,72 @@ void Can::call(const std::string method_name, const std::vector<ConstExpression_
                    arguments[6]->evaluate_integer(),
                    arguments[7]->evaluate_integer(),
                    arguments[8]->evaluate_integer());
-    } else if (method_name == "status") {
-        Module::expect(arguments, 0);
-        echo("state:            %s", this->properties.at("state")->string_value.c_str());
-        echo("msgs_to_tx:       %d", (int)this->properties.at("msgs_to_tx")->integer_value);
-        echo("msgs_to_rx:       %d", (int)this->properties.at("msgs_to_rx")->integer_value);
-        echo("tx_error_counter: %d", (int)this->properties.at("tx_error_counter")->integer_value);
-        echo("rx_error_counter: %d", (int)this->properties.at("rx_error_counter")->integer_value);
-        echo("tx_failed_count:  %d", (int)this->properties.at("tx_failed_count")->integer_value);
-        echo("rx_missed_count:  %d", (int)this->properties.at("rx_missed_count")->integer_value);
-        echo("rx_overrun_count: %d", (int)this->properties.at("rx_overrun_count")->integer_value);
-        echo("arb_lost_count:   %d", (int)this->properties.at("arb_lost_count")->integer_value);
-        echo("bus_error_count:  %d", (int)this->properties.at("bus_error_count")->integer_value);
-    } else if (method_name == "start") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::status:
+        echo("state:            %s", this->property(PropertyId::state)->string_value->c_str());
+        echo("msgs_to_tx:       %d", (int)this->property(PropertyId::msgs_to_tx)->integer_value);
+        echo("msgs_to_rx:       %d", (int)this->property(PropertyId::msgs_to_rx)->integer_value);
+        echo("tx_error_counter: %d", (int)this->property(PropertyId::tx_error_counter)->integer_value);
+        echo("rx_error_counter: %d", (int)this->property(PropertyId::rx_error_counter)->integer_value);
+        echo("tx_failed_count:  %d", (int)this->property(PropertyId::tx_failed_count)->integer_value);
+        echo("rx_missed_count:  %d", (int)this->property(PropertyId::rx_missed_count)->integer_value);
+        echo("rx_overrun_count: %d", (int)this->property(PropertyId::rx_overrun_count)->integer_value);
+        echo("arb_lost_count:   %d", (int)this->property(PropertyId::arb_lost_count)->integer_value);
+        echo("bus_error_count:  %d", (int)this->property(PropertyId::bus_error_count)->integer_value);
+        echo("rx_dispatched:    %d", (int)this->property(PropertyId::rx_dispatched)->integer_value);
+        echo("rx_unsubscribed:  %d", (int)this->property(PropertyId::rx_unsubscribed)->integer_value);
+        echo("tx_pending:       %d", (int)this->property(PropertyId::tx_pending)->integer_value);
+        echo("tx_coalesced:     %d", (int)this->property(PropertyId::tx_coalesced)->integer_value);
+        echo("tx_dropped:       %d", (int)this->property(PropertyId::tx_dropped)->integer_value);
+        echo("tx_latency_max:   %d us", (int)this->property(PropertyId::tx_latency_max)->integer_value);
+        echo("filter:           %s code 0x%08lx mask 0x%08lx",
+             this->f_config.single_filter ? "single" : "dual",
+             (unsigned long)this->f_config.acceptance_code,
+             (unsigned long)this->f_config.acceptance_mask);
+        break;
+    case MethodId::start:
         if (twai_start() != ESP_OK) {
             throw std::runtime_error("could not start twai driver");
         }
-    } else if (method_name == "stop") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::stop:
         if (twai_stop() != ESP_OK) {
             throw std::runtime_error("could not stop twai driver");
         }
-    } else if (method_name == "recover") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::recover:
         if (twai_initiate_recovery() != ESP_OK) {
             throw std::runtime_error("could not initiate recovery");
         }
-    } else {
-        Module::call(method_name, arguments);
+        break;
+    default:
+        Module::call(method_id, arguments);
     }
 }
 
-void Can::subscribe(const uint32_t id, const Module_ptr module) {
-    if (this->subscribers.count(id)) {
+void Can::subscribe(const uint32_t id, const Module_ptr module, const bool extended) {
+    const bool is_extended = extended || id > TWAI_STD_ID_MASK;
+    if (is_extended ? this->extended_dispatch_map.count(id) > 0 : this->standard_dispatch_table[id] != 0) {
         throw std::runtime_error("there is already a subscriber for this CAN ID");
     }
-    this->subscribers[id] = module;
+    size_t index = 0;
+    while (index < this->subscribers.size() && this->subscribers[index] != module) {
+        index++;
+    }
+    if (index == this->subscribers.size()) {
+        if (index >= 255) {
+            throw std::runtime_error("too many CAN subscribers");
+        }
+        this->subscribers.push_back(module);
+    }
+    if (is_extended) {
+        this->extended_dispatch_map[id] = index + 1;
+    } else {
+        this->standard_dispatch_table[id] = index + 1;
+    }
+    this->is_filter_dirty = true;
+}
+
+int64_t Can::get_rx_timestamp() const {
+    return this->rx_timestamp;
 }
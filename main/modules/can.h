@@ -1,25 +1,118 @@
 #pragma once
 
+#include "../utils/spsc_queue.h"
 #include "driver/gpio.h"
+#include "driver/twai.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "module.h"
+#include <atomic>
+#include <deque>
 #include <memory>
+#include <unordered_map>
+
+#define CAN_NO_ID_BASE UINT32_MAX
+
+enum CanTxPriority {
+    can_tx_emergency,
+    can_tx_sync,
+    can_tx_setpoint,
+    can_tx_config,
+};
 
 class Can;
 using Can_ptr = std::shared_ptr<Can>;
 
 class Can : public Module {
 private:
-    std::map<uint32_t, Module_ptr> subscribers;
+    struct frame_t {
+        twai_message_t message;
+        int64_t timestamp;
+    };
+    struct tx_frame_t {
+        twai_message_t message;
+        int64_t timestamp;
+        uint32_t id_base;
+        CanTxPriority priority;
+    };
+
+    enum class MethodId : unsigned int {
+        send = Module::method_count,
+        status,
+        start,
+        stop,
+        recover,
+        count,
+    };
+    static const std::vector<Method> methods;
+    enum class PropertyId : unsigned int {
+        state,
+        tx_error_counter,
+        rx_error_counter,
+        msgs_to_tx,
+        msgs_to_rx,
+        tx_failed_count,
+        rx_missed_count,
+        rx_overrun_count,
+        arb_lost_count,
+        bus_error_count,
+        rx_dispatched,
+        rx_unsubscribed,
+        tx_pending,
+        tx_coalesced,
+        tx_dropped,
+        tx_latency_max,
+        count,
+    };
+    static const std::vector<Property> property_table;
+
+    std::vector<Module_ptr> subscribers;
+    uint8_t standard_dispatch_table[TWAI_STD_ID_MASK + 1] = {};
+    std::unordered_map<uint32_t, uint8_t> extended_dispatch_map;
+    unsigned int rx_dispatched_count = 0;
+    unsigned int rx_unsubscribed_count = 0;
+    int64_t rx_timestamp = 0;
+
+    std::deque<tx_frame_t> tx_queues[can_tx_config + 1];
+    unsigned int tx_coalesced_count = 0;
+    unsigned int tx_dropped_count = 0;
+    int64_t tx_latency_max = 0;
+
+    twai_general_config_t g_config;
+    twai_timing_config_t t_config;
+    twai_filter_config_t f_config = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+    bool is_filter_dirty = false;
+    bool is_filter_for_output = false;
+#ifdef CONFIG_LIZARD_BUS_IO_TASKS
+    SpscQueue<frame_t> rx_queue{CONFIG_LIZARD_CAN_RX_RING_DEPTH};
+    TaskHandle_t rx_task = nullptr;
+    std::atomic<bool> is_rx_pause_requested{false};
+    std::atomic<bool> is_rx_paused{false};
+
+    static void run_rx_task(void *arg);
+#endif
+
+    bool pop_frame(frame_t &frame);
+    void flush_tx();
+    size_t count_pending_tx() const;
+    twai_filter_config_t compute_filter() const;
+    void update_filter();
 
 public:
     Can(const std::string name, const gpio_num_t rx_pin, const gpio_num_t tx_pin, const long baud_rate);
     void step() override;
     bool receive();
-    void send(const uint32_t id, const uint8_t data[8], const bool rtr = false, const uint8_t dlc = 8) const;
+    void send(const uint32_t id, const uint8_t data[8], const bool rtr = false, const uint8_t dlc = 8,
+              const CanTxPriority priority = can_tx_config, const uint32_t id_base = CAN_NO_ID_BASE);
     void send(const uint32_t id,
               const uint8_t d0, const uint8_t d1, const uint8_t d2, const uint8_t d3,
               const uint8_t d4, const uint8_t d5, const uint8_t d6, const uint8_t d7,
-              const bool rtr = false) const;
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
-    void subscribe(const uint32_t id, const Module_ptr module);
+              const bool rtr = false, const CanTxPriority priority = can_tx_config, const uint32_t id_base = CAN_NO_ID_BASE);
+    const std::vector<Property> &get_property_table() const override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
+    void subscribe(const uint32_t id, const Module_ptr module, const bool extended = false);
+    void discard_tx(const uint32_t id);
+    int64_t get_rx_timestamp() const;
 };
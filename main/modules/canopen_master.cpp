@@ -3,20 +3,26 @@
 #include <cassert>
 #include <esp_timer.h>
 
-static constexpr char PROP_SYNC_INTERVAL[]{"sync_interval"};
+const std::vector<Property> CanOpenMaster::property_table = create_property_table<PropertyId::count>({
+    {"sync_interval", integer},
+});
+
+const std::vector<Property> &CanOpenMaster::get_property_table() const {
+    return CanOpenMaster::property_table;
+}
 
 CanOpenMaster::CanOpenMaster(const std::string &name, const Can_ptr can)
     : Module(canopen_master, name), can(can) {
-    this->properties[PROP_SYNC_INTERVAL] = std::make_shared<IntegerVariable>(0);
+    this->create_properties();
 }
 
 void CanOpenMaster::send_sync() {
-    this->can->send(0x80, &sync_counter, false, 1);
+    this->can->send(0x80, &sync_counter, false, 1, can_tx_sync);
     sync_counter++;
 }
 
 void CanOpenMaster::step() {
-    int64_t sync_interval = this->properties[PROP_SYNC_INTERVAL]->integer_value;
+    int64_t sync_interval = this->property(PropertyId::sync_interval)->integer_value;
     if (sync_interval == 0) {
         return;
     }
@@ -11,6 +11,11 @@ using CanOpenMaster_ptr = std::shared_ptr<CanOpenMaster>;
 
 class CanOpenMaster : public Module, public std::enable_shared_from_this<CanOpenMaster> {
 private:
+    enum class PropertyId : unsigned int {
+        sync_interval,
+        count,
+    };
+    static const std::vector<Property> property_table;
     const Can_ptr can;
     int64_t sync_interval_counter = 0;
     uint8_t sync_counter = 0;
@@ -19,5 +24,6 @@ private:
 
 public:
     CanOpenMaster(const std::string &name, const Can_ptr can);
+    const std::vector<Property> &get_property_table() const override;
     void step() override;
 };
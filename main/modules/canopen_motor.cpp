@@ -160,46 +160,38 @@ static uint8_t check_node_id(int64_t id) {
     return static_cast<uint8_t>(id);
 }
 
-static const std::string PROP_INITIALIZED{"initialized"};
-static const std::string PROP_PENDING_READS{"pending_sdo_reads"};
-static const std::string PROP_PENDING_WRITES{"pending_sdo_writes"};
-static const std::string PROP_HEARTBEAT{"last_heartbeat"};
-static const std::string PROP_301_STATE{"raw_state"};
-static const std::string PROP_301_STATE_BOOTING{"is_booting"};
-static const std::string PROP_301_STATE_PREOP{"is_preoperational"};
-static const std::string PROP_301_STATE_OP{"is_operational"};
-static const std::string PROP_OFFSET{"position_offset"};
-static const std::string PROP_POSITION{"actual_position"};
-static const std::string PROP_VELOCITY{"actual_velocity"};
-static const std::string PROP_402_OP_ENA{"status_enabled"};
-static const std::string PROP_402_FAULT{"status_fault"};
-static const std::string PROP_TARGET_REACHED{"status_target_reached"};
-static const std::string PROP_PP_SET_POINT_ACK{"pp_set_point_acknowledge"};
-static const std::string PROP_PV_IS_MOVING{"pv_is_moving"};
-static const std::string PROP_CTRL_ENA_OP{"ctrl_enable"};
-static const std::string PROP_CTRL_HALT{"ctrl_halt"};
+const std::vector<Property> CanOpenMotor::property_table = create_property_table<PropertyId::count>({
+    {"initialized", boolean},
+    {"pending_sdo_reads", integer},
+    {"pending_sdo_writes", integer},
+    {"last_heartbeat", integer},
+    {"raw_state", integer},
+    {"is_booting", boolean},
+    {"is_preoperational", boolean},
+    {"is_operational", boolean},
+    {"position_offset", integer},
+    {"actual_position", integer},
+    {"actual_velocity", integer},
+    {"status_enabled", boolean},
+    {"status_fault", boolean},
+    {"status_target_reached", boolean},
+    {"pp_set_point_acknowledge", boolean},
+    {"pv_is_moving", boolean},
+    {"ctrl_enable", boolean},
+    {"ctrl_halt", boolean},
+});
+
+const std::vector<Property> &CanOpenMotor::get_property_table() const {
+    return CanOpenMotor::property_table;
+}
 
 CanOpenMotor::CanOpenMotor(const std::string &name, Can_ptr can, int64_t node_id)
     : Module(canopen_motor, name), can(can), node_id(check_node_id(node_id)),
       current_op_mode_disp(OP_MODE_NONE), current_op_mode(OP_MODE_NONE) {
-    this->properties[PROP_INITIALIZED] = std::make_shared<BooleanVariable>(false);
-    this->properties[PROP_PENDING_READS] = std::make_shared<IntegerVariable>(0);
-    this->properties[PROP_PENDING_WRITES] = std::make_shared<IntegerVariable>(0);
-    this->properties[PROP_HEARTBEAT] = std::make_shared<IntegerVariable>(-1);
-    this->properties[PROP_301_STATE] = std::make_shared<IntegerVariable>(-1);
-    this->properties[PROP_301_STATE_BOOTING] = std::make_shared<BooleanVariable>(false);
-    this->properties[PROP_301_STATE_PREOP] = std::make_shared<BooleanVariable>(false);
-    this->properties[PROP_301_STATE_OP] = std::make_shared<BooleanVariable>(false);
-    this->properties[PROP_OFFSET] = std::make_shared<IntegerVariable>(0);
-    this->properties[PROP_POSITION] = std::make_shared<IntegerVariable>(0);
-    this->properties[PROP_VELOCITY] = std::make_shared<IntegerVariable>(0);
-    this->properties[PROP_402_OP_ENA] = std::make_shared<BooleanVariable>(false);
-    this->properties[PROP_402_FAULT] = std::make_shared<BooleanVariable>(false);
-    this->properties[PROP_TARGET_REACHED] = std::make_shared<BooleanVariable>(false);
-    this->properties[PROP_PP_SET_POINT_ACK] = std::make_shared<BooleanVariable>(false);
-    this->properties[PROP_PV_IS_MOVING] = std::make_shared<BooleanVariable>(false);
-    this->properties[PROP_CTRL_ENA_OP] = std::make_shared<BooleanVariable>(false);
-    this->properties[PROP_CTRL_HALT] = std::make_shared<BooleanVariable>(true);
+    this->create_properties();
+    this->property(PropertyId::last_heartbeat)->set_integer(-1);
+    this->property(PropertyId::raw_state)->set_integer(-1);
+    this->property(PropertyId::ctrl_halt)->set_boolean(true);
 }
 
 void CanOpenMotor::wait_for_sdo_writes(uint32_t timeout_ms) {
@@ -211,7 +203,7 @@ void CanOpenMotor::wait_for_sdo_writes(uint32_t timeout_ms) {
             ;
         delay(ms_per_sleep);
 
-        if (this->properties[PROP_PENDING_WRITES]->integer_value == 0) {
+        if (this->property(PropertyId::pending_sdo_writes)->integer_value == 0) {
             return;
         }
     }
@@ -223,7 +215,7 @@ void CanOpenMotor::enter_position_mode(int velocity) {
     write_od_u8(OP_MODE_U8, 0x00, OP_MODE_PROFILE_POSITION);
     send_target_velocity(velocity);
     /* Take off halt (=brake) for positioning by default */
-    this->properties[PROP_CTRL_HALT]->boolean_value = false;
+    this->property(PropertyId::ctrl_halt)->set_boolean(false);
     send_control_word(build_ctrl_word(false));
 
     current_op_mode = OP_MODE_PROFILE_POSITION;
@@ -231,7 +223,7 @@ void CanOpenMotor::enter_position_mode(int velocity) {
 
 void CanOpenMotor::enter_velocity_mode(int velocity) {
     /* Put in halt for velocity mode since it directly controls motion */
-    this->properties[PROP_CTRL_HALT]->boolean_value = true;
+    this->property(PropertyId::ctrl_halt)->set_boolean(true);
     send_control_word(build_ctrl_word(false));
     send_target_velocity(velocity);
     write_od_u8(OP_MODE_U8, 0x00, OP_MODE_PROFILE_VELOCITY);
@@ -261,44 +253,67 @@ void CanOpenMotor::subscribe_to_can() {
 void CanOpenMotor::step() {
 }
 
-void CanOpenMotor::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (!this->properties[PROP_INITIALIZED]->boolean_value) {
+const std::vector<Method> CanOpenMotor::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"enter_pp_mode", {integer}},
+    {"enter_pv_mode", {integer}},
+    {"set_target_position", {integer}},
+    {"commit_target_position"},
+    {"set_target_velocity", {integer}},
+    {"set_ctrl_halt", {boolean}},
+    {"set_ctrl_enable", {boolean}},
+    {"reset_fault"},
+    {"sdo_read", {integer}},
+    {"set_profile_acceleration", {integer}},
+    {"set_profile_deceleration", {integer}},
+    {"set_profile_quick_stop_deceleration", {integer}},
+});
+
+const std::vector<Method> &CanOpenMotor::get_methods() const {
+    return CanOpenMotor::methods;
+}
+
+void CanOpenMotor::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    if (!this->property(PropertyId::initialized)->boolean_value) {
         throw std::runtime_error("CanOpenMotor: Not initialized!");
     }
 
-    if (method_name == "enter_pp_mode") {
-        expect(arguments, 1, integer);
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::enter_pp_mode: {
         int64_t velocity = arguments[0]->evaluate_integer();
         enter_position_mode(velocity);
-    } else if (method_name == "enter_pv_mode") {
-        expect(arguments, 1, integer);
+        break;
+    }
+    case MethodId::enter_pv_mode: {
         int64_t velocity = arguments[0]->evaluate_integer();
         enter_velocity_mode(velocity);
-    } else if (method_name == "set_target_position") {
-        expect(arguments, 1, integer);
+        break;
+    }
+    case MethodId::set_target_position: {
         int32_t target_position = arguments[0]->evaluate_integer();
-        int32_t offset = this->properties[PROP_OFFSET]->integer_value;
+        int32_t offset = this->property(PropertyId::position_offset)->integer_value;
         send_target_position(target_position + offset);
-    } else if (method_name == "commit_target_position") {
-        expect(arguments, 0);
+        break;
+    }
+    case MethodId::commit_target_position:
         /* toggle new set point bit in control word */
         send_control_word(build_ctrl_word(true));
-    } else if (method_name == "set_target_velocity") {
-        expect(arguments, 1, integer);
+        break;
+    case MethodId::set_target_velocity: {
         int32_t target_velocity = arguments[0]->evaluate_integer();
         send_target_velocity(target_velocity);
-    } else if (method_name == "set_ctrl_halt") {
-        expect(arguments, 1, boolean);
-        this->properties[PROP_CTRL_HALT]->boolean_value = arguments[0]->evaluate_boolean();
+        break;
+    }
+    case MethodId::set_ctrl_halt:
+        this->property(PropertyId::ctrl_halt)->set_boolean(arguments[0]->evaluate_boolean());
         send_control_word(build_ctrl_word(false));
-    } else if (method_name == "set_ctrl_enable") {
-        expect(arguments, 1, boolean);
-        this->properties[PROP_CTRL_ENA_OP]->boolean_value = arguments[0]->evaluate_boolean();
+        break;
+    case MethodId::set_ctrl_enable:
+        this->property(PropertyId::ctrl_enable)->set_boolean(arguments[0]->evaluate_boolean());
         send_control_word(build_ctrl_word(false));
-    } else if (method_name == "reset_fault") {
-        expect(arguments, 0);
+        break;
+    case MethodId::reset_fault: {
         /* implicitly set halt bit so we don't start moving immediately after the fault is cleared */
-        this->properties[PROP_CTRL_HALT]->boolean_value = true;
+        this->property(PropertyId::ctrl_halt)->set_boolean(true);
         uint16_t ctrl_word = build_ctrl_word(false);
         /* set fault reset bit */
         ctrl_word |= (1 << 7);
@@ -306,37 +321,43 @@ void CanOpenMotor::call(const std::string method_name, const std::vector<ConstEx
         /* and clear it */
         ctrl_word &= ~(1 << 7);
         send_control_word(ctrl_word);
-    } else if (method_name == "sdo_read") {
-        expect(arguments, 1, integer);
+        break;
+    }
+    case MethodId::sdo_read: {
         uint16_t index = arguments[0]->evaluate_integer();
         sdo_read(index, 0);
-    } else if (method_name == "set_profile_acceleration") {
-        expect(arguments, 1, integer);
+        break;
+    }
+    case MethodId::set_profile_acceleration: {
         uint32_t acceleration = arguments[0]->evaluate_integer();
         set_profile_acceleration(acceleration);
-    } else if (method_name == "set_profile_deceleration") {
-        expect(arguments, 1, integer);
+        break;
+    }
+    case MethodId::set_profile_deceleration: {
         uint32_t deceleration = arguments[0]->evaluate_integer();
         set_profile_deceleration(deceleration);
-    } else if (method_name == "set_profile_quick_stop_deceleration") {
-        expect(arguments, 1, integer);
+        break;
+    }
+    case MethodId::set_profile_quick_stop_deceleration: {
         uint32_t deceleration = arguments[0]->evaluate_integer();
         set_profile_quick_stop_deceleration(deceleration);
-    } else {
-        Module::call(method_name, arguments);
+        break;
+    }
+    default:
+        Module::call(method_id, arguments);
     }
 }
 
 void CanOpenMotor::transition_preoperational() {
     uint8_t data[2]{STATE_CHANGE_PREOPERATIONAL, this->node_id};
     /* COB-ID 0 = NMT state transition */
-    this->can->send(0, data, false, sizeof(data));
+    this->can->send(0, data, false, sizeof(data), can_tx_config, this->node_id);
 }
 
 void CanOpenMotor::transition_operational() {
     uint8_t data[2]{STATE_CHANGE_OPERATIONAL, this->node_id};
     /* COB-ID 0 = NMT state transition */
-    this->can->send(0, data, false, sizeof(data));
+    this->can->send(0, data, false, sizeof(data), can_tx_config, this->node_id);
 }
 
 void CanOpenMotor::write_od_u8(uint16_t index, uint8_t sub, uint8_t value) {
@@ -345,8 +366,8 @@ void CanOpenMotor::write_od_u8(uint16_t index, uint8_t sub, uint8_t value) {
     marshal_index(index, sub, &data[1]);
     marshal_unsigned(value, &data[4]);
 
-    can->send(wrap_cob_id(COB_SDO_CLIENT2SERVER, node_id), data);
-    this->properties[PROP_PENDING_WRITES]->integer_value++;
+    can->send(wrap_cob_id(COB_SDO_CLIENT2SERVER, node_id), data, false, 8, can_tx_config, node_id);
+    this->property(PropertyId::pending_sdo_writes)->set_integer(this->property(PropertyId::pending_sdo_writes)->integer_value + 1);
     wait_for_sdo_writes(100);
 }
 
@@ -356,8 +377,8 @@ void CanOpenMotor::write_od_u16(uint16_t index, uint8_t sub, uint16_t value) {
     marshal_index(index, sub, &data[1]);
     marshal_unsigned(value, &data[4]);
 
-    can->send(wrap_cob_id(COB_SDO_CLIENT2SERVER, node_id), data);
-    this->properties[PROP_PENDING_WRITES]->integer_value++;
+    can->send(wrap_cob_id(COB_SDO_CLIENT2SERVER, node_id), data, false, 8, can_tx_config, node_id);
+    this->property(PropertyId::pending_sdo_writes)->set_integer(this->property(PropertyId::pending_sdo_writes)->integer_value + 1);
     wait_for_sdo_writes(100);
 }
 
@@ -367,8 +388,8 @@ void CanOpenMotor::write_od_u32(uint16_t index, uint8_t sub, uint32_t value) {
     marshal_index(index, sub, &data[1]);
     marshal_unsigned(value, &data[4]);
 
-    can->send(wrap_cob_id(COB_SDO_CLIENT2SERVER, node_id), data);
-    this->properties[PROP_PENDING_WRITES]->integer_value++;
+    can->send(wrap_cob_id(COB_SDO_CLIENT2SERVER, node_id), data, false, 8, can_tx_config, node_id);
+    this->property(PropertyId::pending_sdo_writes)->set_integer(this->property(PropertyId::pending_sdo_writes)->integer_value + 1);
     wait_for_sdo_writes(100);
 }
 
@@ -378,8 +399,8 @@ void CanOpenMotor::write_od_i32(uint16_t index, uint8_t sub, int32_t value) {
     marshal_index(index, sub, &data[1]);
     marshal_i32(value, &data[4]);
 
-    can->send(wrap_cob_id(COB_SDO_CLIENT2SERVER, node_id), data);
-    this->properties[PROP_PENDING_WRITES]->integer_value++;
+    can->send(wrap_cob_id(COB_SDO_CLIENT2SERVER, node_id), data, false, 8, can_tx_config, node_id);
+    this->property(PropertyId::pending_sdo_writes)->set_integer(this->property(PropertyId::pending_sdo_writes)->integer_value + 1);
     wait_for_sdo_writes(100);
 }
 
@@ -387,7 +408,7 @@ void CanOpenMotor::sdo_read(uint16_t index, uint8_t sub) {
     uint8_t data[8] = {sdo_read_header};
     marshal_index(index, sub, &data[1]);
 
-    this->can->send(wrap_cob_id(COB_SDO_CLIENT2SERVER, node_id), data);
+    this->can->send(wrap_cob_id(COB_SDO_CLIENT2SERVER, node_id), data, false, 8, can_tx_config, this->node_id);
 }
 
 void CanOpenMotor::write_rpdo_mapping(uint32_t *entries, uint8_t entry_count, uint8_t rpdo) {
@@ -430,17 +451,17 @@ void CanOpenMotor::configure_constants() {
 void CanOpenMotor::handle_heartbeat(const uint8_t *const data) {
     uint8_t actual_state = data[0];
 
-    this->properties[PROP_HEARTBEAT]->integer_value = esp_timer_get_time();
-    this->properties[PROP_301_STATE]->integer_value = actual_state;
+    this->property(PropertyId::last_heartbeat)->set_integer(esp_timer_get_time());
+    this->property(PropertyId::raw_state)->set_integer(actual_state);
 
-    this->properties[PROP_301_STATE_BOOTING]->boolean_value = (actual_state == Booting);
-    this->properties[PROP_301_STATE_PREOP]->boolean_value = (actual_state == Preoperational);
-    this->properties[PROP_301_STATE_OP]->boolean_value = (actual_state == Operational);
+    this->property(PropertyId::is_booting)->set_boolean(actual_state == Booting);
+    this->property(PropertyId::is_preoperational)->set_boolean(actual_state == Preoperational);
+    this->property(PropertyId::is_operational)->set_boolean(actual_state == Operational);
 
     if (actual_state == Booting) {
         /* Possible reboot, restart initialization */
         init_state = WaitingForPreoperational;
-        this->properties[PROP_INITIALIZED]->boolean_value = false;
+        this->property(PropertyId::initialized)->set_boolean(false);
         return;
     }
 
@@ -467,7 +488,7 @@ void CanOpenMotor::handle_heartbeat(const uint8_t *const data) {
     case WaitingForSdoWrites:
         switch (actual_state) {
         case Preoperational:
-            if (this->properties[PROP_PENDING_WRITES]->integer_value > 0) {
+            if (this->property(PropertyId::pending_sdo_writes)->integer_value > 0) {
                 break;
             }
 
@@ -484,7 +505,7 @@ void CanOpenMotor::handle_heartbeat(const uint8_t *const data) {
         switch (actual_state) {
         case Operational:
             init_state = InitDone;
-            this->properties[PROP_INITIALIZED]->boolean_value = true;
+            this->property(PropertyId::initialized)->set_boolean(true);
             break;
 
         case Preoperational:
@@ -517,13 +538,13 @@ void CanOpenMotor::handle_sdo_reply(const uint8_t *const data) {
         break;
 
     case ExpeditedWriteSuccess:
-        assert(this->properties[PROP_PENDING_WRITES]->integer_value > 0);
-        this->properties[PROP_PENDING_WRITES]->integer_value--;
+        assert(this->property(PropertyId::pending_sdo_writes)->integer_value > 0);
+        this->property(PropertyId::pending_sdo_writes)->set_integer(this->property(PropertyId::pending_sdo_writes)->integer_value - 1);
         break;
 
     case WriteFailure:
         /* A failure still acknowledges the write operation */
-        this->properties[PROP_PENDING_WRITES]->integer_value--;
+        this->property(PropertyId::pending_sdo_writes)->set_integer(this->property(PropertyId::pending_sdo_writes)->integer_value - 1);
 
         switch (value) {
         case NonExistantObject:
@@ -547,7 +568,7 @@ void CanOpenMotor::handle_sdo_reply(const uint8_t *const data) {
 void CanOpenMotor::handle_tpdo1(const uint8_t *const data) {
     uint16_t status_word = data[0] | data[1] << 8;
     int32_t actual_position = demarshal_i32(data + 2);
-    actual_position -= this->properties[PROP_OFFSET]->integer_value;
+    actual_position -= this->property(PropertyId::position_offset)->integer_value;
 
     process_status_word_generic(status_word);
 
@@ -557,49 +578,49 @@ void CanOpenMotor::handle_tpdo1(const uint8_t *const data) {
         process_status_word_pv(status_word);
     }
 
-    this->properties[PROP_POSITION]->integer_value = actual_position;
+    this->property(PropertyId::actual_position)->set_integer(actual_position);
 }
 
 void CanOpenMotor::handle_tpdo2(const uint8_t *const data) {
     int32_t actual_velocity = demarshal_i32(data);
-    this->properties[PROP_VELOCITY]->integer_value = actual_velocity;
+    this->property(PropertyId::actual_velocity)->set_integer(actual_velocity);
 }
 
 void CanOpenMotor::process_status_word_generic(const uint16_t status_word) {
-    this->properties[PROP_402_OP_ENA]->boolean_value = status_word >> 2 & 1;
-    this->properties[PROP_402_FAULT]->boolean_value = status_word >> 3 & 1;
-    this->properties[PROP_TARGET_REACHED]->boolean_value = status_word >> 10 & 1;
+    this->property(PropertyId::status_enabled)->set_boolean(status_word >> 2 & 1);
+    this->property(PropertyId::status_fault)->set_boolean(status_word >> 3 & 1);
+    this->property(PropertyId::status_target_reached)->set_boolean(status_word >> 10 & 1);
 }
 
 void CanOpenMotor::process_status_word_pp(const uint16_t status_word) {
-    this->properties[PROP_PP_SET_POINT_ACK]->boolean_value = status_word >> 12 & 1;
+    this->property(PropertyId::pp_set_point_acknowledge)->set_boolean(status_word >> 12 & 1);
 }
 
 void CanOpenMotor::process_status_word_pv(const uint16_t status_word) {
-    this->properties[PROP_PV_IS_MOVING]->boolean_value = status_word >> 12 & 1;
+    this->property(PropertyId::pv_is_moving)->set_boolean(status_word >> 12 & 1);
 }
 
 void CanOpenMotor::send_control_word(uint16_t value) {
     uint8_t data[2];
     marshal_unsigned(value, data);
-    this->can->send(wrap_cob_id(COB_RPDO1, this->node_id), data, false, sizeof(data));
+    this->can->send(wrap_cob_id(COB_RPDO1, this->node_id), data, false, sizeof(data), can_tx_config, this->node_id);
 }
 
 void CanOpenMotor::send_target_position(int32_t value) {
     uint8_t data[4];
     marshal_i32(value, data);
-    this->can->send(wrap_cob_id(COB_RPDO2, this->node_id), data, false, sizeof(data));
+    this->can->send(wrap_cob_id(COB_RPDO2, this->node_id), data, false, sizeof(data), can_tx_setpoint, this->node_id);
 }
 
 void CanOpenMotor::send_target_velocity(int32_t value) {
     uint8_t data[4];
     marshal_i32(value, data);
-    this->can->send(wrap_cob_id(COB_RPDO3, this->node_id), data, false, sizeof(data));
+    this->can->send(wrap_cob_id(COB_RPDO3, this->node_id), data, false, sizeof(data), can_tx_setpoint, this->node_id);
 }
 
 uint16_t CanOpenMotor::build_ctrl_word(bool new_set_point) {
-    uint16_t ena_op_bit = this->properties[PROP_CTRL_ENA_OP]->boolean_value ? 1 : 0;
-    uint16_t halt_bit = this->properties[PROP_CTRL_HALT]->boolean_value ? 1 : 0;
+    uint16_t ena_op_bit = this->property(PropertyId::ctrl_enable)->boolean_value ? 1 : 0;
+    uint16_t halt_bit = this->property(PropertyId::ctrl_halt)->boolean_value ? 1 : 0;
     uint16_t new_set_point_bit = new_set_point ? 1 : 0;
 
     return build_ctrl_base_word(1, 1, 1, ena_op_bit, halt_bit) | build_ctrl_pos_prof_word(new_set_point_bit, 1, 0);
@@ -631,26 +652,26 @@ void CanOpenMotor::handle_can_msg(const uint32_t id, const int count, const uint
 }
 
 void CanOpenMotor::stop() {
-    this->properties[PROP_CTRL_HALT]->boolean_value = true;
+    this->property(PropertyId::ctrl_halt)->set_boolean(true);
     this->send_control_word(build_ctrl_word(false));
 }
 
-double CanOpenMotor::get_position() {
-    return static_cast<double>(this->properties[PROP_POSITION]->integer_value);
+number_t CanOpenMotor::get_position() {
+    return static_cast<number_t>(this->property(PropertyId::actual_position)->integer_value);
 }
 
-void CanOpenMotor::position(const double position, const double speed, const double acceleration) {
+void CanOpenMotor::position(const number_t position, const number_t speed, const number_t acceleration) {
     this->enter_position_mode(static_cast<int32_t>(speed));
-    this->send_target_position(static_cast<int32_t>(position) + this->properties[PROP_OFFSET]->integer_value);
+    this->send_target_position(static_cast<int32_t>(position) + this->property(PropertyId::position_offset)->integer_value);
     send_control_word(build_ctrl_word(true));
 }
 
-double CanOpenMotor::get_speed() {
-    return static_cast<double>(this->properties[PROP_VELOCITY]->integer_value);
+number_t CanOpenMotor::get_speed() {
+    return static_cast<number_t>(this->property(PropertyId::actual_velocity)->integer_value);
 }
 
-void CanOpenMotor::speed(const double speed, const double acceleration) {
+void CanOpenMotor::speed(const number_t speed, const number_t acceleration) {
     this->enter_velocity_mode(speed);
-    this->properties[PROP_CTRL_HALT]->boolean_value = false;
+    this->property(PropertyId::ctrl_halt)->set_boolean(false);
     send_control_word(build_ctrl_word(false));
 }
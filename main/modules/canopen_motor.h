@@ -13,6 +13,45 @@ class CanOpenMotor : public Module, public std::enable_shared_from_this<CanOpenM
     Can_ptr can;
     const uint8_t node_id;
 
+    enum class MethodId : unsigned int {
+        enter_pp_mode = Module::method_count,
+        enter_pv_mode,
+        set_target_position,
+        commit_target_position,
+        set_target_velocity,
+        set_ctrl_halt,
+        set_ctrl_enable,
+        reset_fault,
+        sdo_read,
+        set_profile_acceleration,
+        set_profile_deceleration,
+        set_profile_quick_stop_deceleration,
+        count,
+    };
+    static const std::vector<Method> methods;
+    enum class PropertyId : unsigned int {
+        initialized,
+        pending_sdo_reads,
+        pending_sdo_writes,
+        last_heartbeat,
+        raw_state,
+        is_booting,
+        is_preoperational,
+        is_operational,
+        position_offset,
+        actual_position,
+        actual_velocity,
+        status_enabled,
+        status_fault,
+        status_target_reached,
+        pp_set_point_acknowledge,
+        pv_is_moving,
+        ctrl_enable,
+        ctrl_halt,
+        count,
+    };
+    static const std::vector<Property> property_table;
+
     enum {
         /* No preop HB received yet */
         WaitingForPreoperational,
@@ -65,12 +104,14 @@ public:
     CanOpenMotor(const std::string &name, const Can_ptr can, int64_t node_id);
     void subscribe_to_can();
     void step() override;
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Property> &get_property_table() const override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
     void handle_can_msg(const uint32_t id, const int count, const uint8_t *const data) override;
 
     void stop() override;
-    double get_position() override;
-    void position(const double position, const double speed, const double acceleration) override;
-    double get_speed() override;
-    void speed(const double speed, const double acceleration) override;
+    number_t get_position() override;
+    void position(const number_t position, const number_t speed, const number_t acceleration) override;
+    number_t get_speed() override;
+    void speed(const number_t speed, const number_t acceleration) override;
 };
@@ -1,6 +1,9 @@
 #include "core.h"
+#include "../compilation/statement_cache.h"
 #include "../global.h"
 #include "../storage.h"
+#include "../utils/format.h"
+#include "../utils/framing.h"
 #include "../utils/ota.h"
 #include "../utils/string_utils.h"
 #include "../utils/timing.h"
@@ -8,37 +11,170 @@
 #include "esp_ota_ops.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <cmath>
+#include <cstring>
 #include <memory>
 #include <stdlib.h>
 
+#define BAUD_CONFIRMATION_TIMEOUT_MS 2000
+
+const std::vector<Property> Core::property_table = create_property_table<PropertyId::count>({
+    {"debug", boolean},
+    {"millis", integer},
+    {"heap", integer},
+    {"last_message_age", integer},
+    {"rules_evaluated", integer},
+    {"rules_skipped", integer},
+    {"cache_size", integer},
+    {"cache_hit_rate", number},
+    {"cache_hit_latency", number},
+    {"rate", number},
+    {"loop_period", number},
+    {"loop_jitter_max", number},
+    {"loop_overruns", integer},
+    {"tx_queued", integer},
+    {"tx_dropped", integer},
+});
+
+static std::vector<struct output_element_t> parse_output_format(std::string format) {
+    std::vector<struct output_element_t> elements;
+    while (!format.empty()) {
+        std::string element = cut_first_word(format);
+        if (element.find('.') == std::string::npos) {
+            // variable[:precision]
+            std::string variable_name = cut_first_word(element, ':');
+            const unsigned int precision = element.empty() ? 0 : atoi(element.c_str());
+            elements.push_back({nullptr, variable_name, precision, element == "r", nullptr});
+        } else {
+            // module.property[:precision]
+            std::string module_name = cut_first_word(element, '.');
+            const ConstModule_ptr module = Global::get_module(module_name);
+            const std::string property_name = cut_first_word(element, ':');
+            const unsigned int precision = element.empty() ? 0 : atoi(element.c_str());
+            elements.push_back({module, property_name, precision, element == "r", nullptr});
+        }
+    }
+    return elements;
+}
+
+static void resolve_output_plan(struct output_plan_t &plan) {
+    if (plan.is_resolved && plan.generation == Global::generation) {
+        return;
+    }
+    for (auto &element : plan.elements) {
+        element.variable = element.module ? element.module->get_property(element.property_name)
+                                          : Global::get_variable(element.property_name);
+    }
+    plan.is_resolved = true;
+    plan.generation = Global::generation;
+}
+
+static int print_output_plan(const struct output_plan_t &plan, char *buffer) {
+    int pos = 0;
+    for (auto const &element : plan.elements) {
+        if (pos > 0) {
+            buffer[pos++] = ' ';
+        }
+        const ConstVariable_ptr &variable = element.variable;
+        switch (variable->type) {
+        case boolean:
+            pos += sprintf(&buffer[pos], "%s", variable->boolean_value ? "true" : "false");
+            break;
+        case integer:
+            pos += format_integer(&buffer[pos], variable->integer_value);
+            break;
+        case number:
+            pos += element.is_round_trip ? format_number_shortest(&buffer[pos], variable->number_value)
+                                         : format_number(&buffer[pos], variable->number_value, element.precision);
+            break;
+        case string:
+            pos += sprintf(&buffer[pos], "\"%s\"", variable->string_value->c_str());
+            break;
+        default:
+            throw std::runtime_error("invalid type");
+        }
+    }
+    buffer[pos] = '\0';
+    return pos;
+}
+
+const std::vector<Property> &Core::get_property_table() const {
+    return Core::property_table;
+}
+
 Core::Core(const std::string name) : Module(core, name) {
-    this->properties["debug"] = std::make_shared<BooleanVariable>(false);
-    this->properties["millis"] = std::make_shared<IntegerVariable>();
-    this->properties["heap"] = std::make_shared<IntegerVariable>();
-    this->properties["last_message_age"] = std::make_shared<IntegerVariable>();
+    this->create_properties();
+    this->property(PropertyId::rate)->set_number(100);
 }
 
 void Core::step() {
-    this->properties.at("millis")->integer_value = millis();
-    this->properties.at("heap")->integer_value = xPortGetFreeHeapSize();
-    this->properties.at("last_message_age")->integer_value = millis_since(this->last_message_millis);
+    this->property(PropertyId::millis)->set_integer(millis());
+    this->property(PropertyId::heap)->set_integer(xPortGetFreeHeapSize());
+    this->property(PropertyId::last_message_age)->set_integer(millis_since(this->last_message_millis));
+    this->property(PropertyId::rules_evaluated)->set_integer(Rule::evaluated_count);
+    this->property(PropertyId::rules_skipped)->set_integer(Rule::skipped_count);
+    const unsigned int cache_lookups = StatementCache::hit_count + StatementCache::miss_count;
+    this->property(PropertyId::cache_size)->set_integer(StatementCache::size());
+    this->property(PropertyId::cache_hit_rate)->set_number(cache_lookups ? (number_t)StatementCache::hit_count / cache_lookups : 0);
+    this->property(PropertyId::cache_hit_latency)->set_number(
+        StatementCache::hit_count ? (number_t)StatementCache::hit_micros / StatementCache::hit_count : 0);
+    this->property(PropertyId::tx_queued)->set_integer(get_tx_bytes_queued());
+    this->property(PropertyId::tx_dropped)->set_integer(get_tx_bytes_dropped());
+    if (this->output_on && this->is_binary_output) {
+        this->write_binary_output();
+    }
+    if (this->output_on && !this->is_binary_output) {
+        resolve_output_plan(this->output_plan);
+    }
+    if (this->unconfirmed_baud_rate && millis_since(this->baud_switch_millis) > BAUD_CONFIRMATION_TIMEOUT_MS) {
+        const uint32_t baud_rate = this->unconfirmed_baud_rate;
+        this->unconfirmed_baud_rate = 0;
+        set_baud_rate(CONFIG_LIZARD_BAUD_RATE);
+        echo("warning: baud rate %lu was not confirmed, falling back to %d", (unsigned long)baud_rate, CONFIG_LIZARD_BAUD_RATE);
+    }
+    this->write_subscriptions();
     Module::step();
 }
 
-void Core::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (method_name == "restart") {
-        Module::expect(arguments, 0);
+const std::vector<Method> Core::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"restart"},
+    {"version", 0, -1},
+    {"info"},
+    {"print", 0, -1},
+    {"output", {string}},
+    {"startup_checksum", 0, -1},
+    {"ota", {string, string, string}},
+    {"output_binary", 1, 2, {string, integer}},
+    {"subscribe", {string, string, numbery}},
+    {"unsubscribe", {string}},
+    {"watch", 1, 2, {string, numbery}},
+    {"unwatch", {string}},
+    {"baud", {integer}},
+    {"confirm_baud"},
+});
+
+const std::vector<Method> &Core::get_methods() const {
+    return Core::methods;
+}
+
+void Core::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::restart:
         esp_restart();
-    } else if (method_name == "version") {
+        break;
+    case MethodId::version: {
         const esp_app_desc_t *app_desc = esp_ota_get_app_description();
         echo("version: %s", app_desc->version);
-    } else if (method_name == "info") {
-        Module::expect(arguments, 0);
+        break;
+    }
+    case MethodId::info: {
         const esp_app_desc_t *app_desc = esp_ota_get_app_description();
         echo("lizard version: %s", app_desc->version);
         echo("compile time: %s, %s", app_desc->date, app_desc->time);
         echo("idf version: %s", app_desc->idf_ver);
-    } else if (method_name == "print") {
+        break;
+    }
+    case MethodId::print: {
         static char buffer[1024];
         int pos = 0;
         for (auto const &argument : arguments) {
@@ -48,75 +184,369 @@ void Core::call(const std::string method_name, const std::vector<ConstExpression
             pos += argument->print_to_buffer(&buffer[pos]);
         }
         echo(buffer);
-    } else if (method_name == "output") {
-        Module::expect(arguments, 1, string);
-        this->output_list.clear();
-        std::string format = arguments[0]->evaluate_string();
-        while (!format.empty()) {
-            std::string element = cut_first_word(format);
-            if (element.find('.') == std::string::npos) {
-                // variable[:precision]
-                std::string variable_name = cut_first_word(element, ':');
-                const unsigned int precision = element.empty() ? 0 : atoi(element.c_str());
-                this->output_list.push_back({nullptr, variable_name, precision});
-            } else {
-                // module.property[:precision]
-                std::string module_name = cut_first_word(element, '.');
-                const ConstModule_ptr module = Global::get_module(module_name);
-                const std::string property_name = cut_first_word(element, ':');
-                const unsigned int precision = element.empty() ? 0 : atoi(element.c_str());
-                this->output_list.push_back({module, property_name, precision});
-            }
-        }
+        break;
+    }
+    case MethodId::output: {
+        this->is_binary_output = false;
+        this->output_plan = {parse_output_format(arguments[0]->evaluate_string())};
         this->output_on = true;
-    } else if (method_name == "startup_checksum") {
+        break;
+    }
+    case MethodId::startup_checksum: {
         uint16_t checksum = 0;
         for (char const &c : Storage::startup) {
             checksum += c;
         }
         echo("checksum: %04x", checksum);
-    } else if (method_name == "ota") {
-        Module::expect(arguments, 3, string, string, string);
+        break;
+    }
+    case MethodId::ota: {
         auto *params = new ota::ota_params_t{
             arguments[0]->evaluate_string(),
             arguments[1]->evaluate_string(),
             arguments[2]->evaluate_string(),
         };
         xTaskCreate(ota::ota_task, "ota_task", 8192, params, 5, nullptr);
-    } else {
-        Module::call(method_name, arguments);
+        break;
+    }
+    case MethodId::output_binary: {
+        std::vector<struct binary_output_element_t> elements;
+        const int64_t keyframe_interval = arguments.size() > 1 ? arguments[1]->evaluate_integer() : 0;
+        if (keyframe_interval < 0) {
+            throw std::runtime_error("keyframe interval must not be negative");
+        }
+        std::string schema = keyframe_interval > 0 ? " delta" : "";
+        size_t payload_size = 1 + 2;
+        std::string format = arguments[0]->evaluate_string();
+        while (!format.empty()) {
+            std::string element = cut_first_word(format);
+            std::string property_name = cut_first_word(element, ':');
+            const std::string name = property_name;
+            const std::string module_name = property_name.find('.') == std::string::npos ? "" : cut_first_word(property_name, '.');
+            const ConstVariable_ptr variable = module_name.empty() ? Global::get_variable(property_name)
+                                                                   : Global::get_module(module_name)->get_property(property_name);
+            switch (variable->type) {
+            case boolean:
+                schema += " " + name + ":?";
+                payload_size += 1;
+                break;
+            case integer:
+                schema += " " + name + ":q";
+                payload_size += 8;
+                break;
+            case number:
+                schema += " " + name + ":f";
+                payload_size += 4;
+                break;
+            default:
+                throw std::runtime_error("binary output only supports booleans, integers and numbers");
+            }
+            const float deadband = keyframe_interval > 0 && !element.empty() ? atof(element.c_str()) : 0;
+            elements.push_back({variable, deadband, 0, 0});
+        }
+        if (keyframe_interval > 0) {
+            payload_size += 1 + (elements.size() + 7) / 8;
+        }
+        if (payload_size > 254) {
+            throw std::runtime_error("too many values for binary output");
+        }
+        this->binary_output_list = elements;
+        this->binary_schema_id++;
+        this->keyframe_interval = keyframe_interval;
+        this->frames_since_keyframe = 0;
+        this->is_binary_output = true;
+        this->output_on = true;
+        echo("schema %d%s", this->binary_schema_id, schema.c_str());
+        break;
+    }
+    case MethodId::subscribe: {
+        const std::string name = arguments[0]->evaluate_string();
+        const number_t rate = arguments[2]->evaluate_number();
+        if (name.empty() || name.find(' ') != std::string::npos || Global::has_module(name)) {
+            throw std::runtime_error("invalid subscription name \"" + name + "\"");
+        }
+        if (rate <= 0) {
+            throw std::runtime_error("subscription rate must be positive");
+        }
+        this->subscriptions[name] = {{parse_output_format(arguments[1]->evaluate_string())}, rate};
+        break;
+    }
+    case MethodId::unsubscribe: {
+        if (!this->subscriptions.erase(arguments[0]->evaluate_string())) {
+            throw std::runtime_error("unknown subscription \"" + arguments[0]->evaluate_string() + "\"");
+        }
+        break;
+    }
+    case MethodId::watch: {
+        std::string name = arguments[0]->evaluate_string();
+        const number_t deadband = arguments.size() > 1 ? arguments[1]->evaluate_number() : 0;
+        std::string property_name = name;
+        const std::string module_name = property_name.find('.') == std::string::npos ? "" : cut_first_word(property_name, '.');
+        const ConstVariable_ptr variable = module_name.empty() ? Global::get_variable(property_name)
+                                                               : Global::get_module(module_name)->get_property(property_name);
+        if (variable->type == identifier) {
+            throw std::runtime_error("identifiers can not be watched");
+        }
+        for (auto it = this->watches.begin(); it != this->watches.end(); ++it) {
+            if (it->name == name) {
+                this->watches.erase(it);
+                break;
+            }
+        }
+        this->watches.push_back({name, variable, deadband, variable->generation, 0});
+        this->watches.back().last_value = variable->type == integer ? variable->integer_value
+                                          : variable->type == number ? variable->number_value
+                                                                     : 0;
+        static char buffer[1024];
+        variable->print_to_buffer(buffer);
+        echo("event %s %s", name.c_str(), buffer);
+        break;
+    }
+    case MethodId::unwatch: {
+        const std::string name = arguments[0]->evaluate_string();
+        for (auto it = this->watches.begin(); it != this->watches.end(); ++it) {
+            if (it->name == name) {
+                this->watches.erase(it);
+                return;
+            }
+        }
+        throw std::runtime_error("property \"" + name + "\" is not watched");
+    }
+    case MethodId::baud: {
+        const int64_t baud_rate = arguments[0]->evaluate_integer();
+        if (baud_rate < 9600 || baud_rate > 5000000) {
+            throw std::runtime_error("baud rate must be between 9600 and 5000000");
+        }
+        echo("baud %lld", baud_rate);
+        set_baud_rate(baud_rate);
+        this->unconfirmed_baud_rate = baud_rate == CONFIG_LIZARD_BAUD_RATE ? 0 : baud_rate;
+        this->baud_switch_millis = millis();
+        break;
+    }
+    case MethodId::confirm_baud: {
+        if (!this->unconfirmed_baud_rate) {
+            throw std::runtime_error("there is no baud rate to confirm");
+        }
+        echo("baud %lu confirmed", (unsigned long)this->unconfirmed_baud_rate);
+        this->unconfirmed_baud_rate = 0;
+        break;
+    }
+    default:
+        Module::call(method_id, arguments);
     }
 }
 
-std::string Core::get_output() const {
-    static char output_buffer[1024];
-    int pos = 0;
-    for (auto const &element : this->output_list) {
-        if (pos > 0) {
-            pos += sprintf(&output_buffer[pos], " ");
+void Core::check_watches() {
+    static char buffer[1024];
+    for (auto &watch : this->watches) {
+        const ConstVariable_ptr &variable = watch.variable;
+        if (variable->generation == watch.generation) {
+            continue;
         }
-        const Variable_ptr variable =
-            element.module ? element.module->get_property(element.property_name) : Global::get_variable(element.property_name);
+        watch.generation = variable->generation;
+        if (variable->type == integer || variable->type == number) {
+            const number_t value = variable->type == integer ? variable->integer_value : variable->number_value;
+            if (std::fabs(value - watch.last_value) <= watch.deadband) {
+                continue;
+            }
+            watch.last_value = value;
+        }
+        variable->print_to_buffer(buffer);
+        echo("event %s %s", watch.name.c_str(), buffer);
+    }
+}
+
+void Core::write_subscriptions() {
+    static char buffer[1024];
+    const number_t loop_rate = this->get_rate();
+    for (auto &[name, subscription] : this->subscriptions) {
+        if (subscription.rate < loop_rate && this->cycle % std::lround(loop_rate / subscription.rate) != 0) {
+            continue;
+        }
+        resolve_output_plan(subscription.plan);
+        print_output_plan(subscription.plan, buffer);
+        echo_telemetry("%s %s", name.c_str(), buffer);
+    }
+}
+
+void Core::write_binary_output() {
+    static uint8_t payload[254];
+    static uint8_t frame[258];
+    size_t pos = 0;
+    payload[pos++] = this->binary_schema_id;
+
+    const bool is_delta = this->keyframe_interval > 0;
+    const bool is_keyframe = !is_delta || this->frames_since_keyframe == 0;
+    const size_t bitmask_size = (this->binary_output_list.size() + 7) / 8;
+    uint8_t *const bitmask = &payload[pos + 1];
+    if (is_delta) {
+        this->frames_since_keyframe = (this->frames_since_keyframe + 1) % this->keyframe_interval;
+        payload[pos++] = this->delta_sequence;
+        memset(bitmask, 0, bitmask_size);
+        pos += bitmask_size;
+    }
+    bool has_changes = false;
+    for (size_t i = 0; i < this->binary_output_list.size(); ++i) {
+        binary_output_element_t &element = this->binary_output_list[i];
+        const ConstVariable_ptr &variable = element.variable;
+        int64_t integer_value = 0;
+        float number_value = 0;
         switch (variable->type) {
         case boolean:
-            pos += sprintf(&output_buffer[pos], "%s", variable->boolean_value ? "true" : "false");
+            integer_value = variable->boolean_value ? 1 : 0;
             break;
         case integer:
-            pos += sprintf(&output_buffer[pos], "%lld", variable->integer_value);
+            integer_value = variable->integer_value;
             break;
-        case number:
-            pos += sprintf(&output_buffer[pos], "%.*f", element.precision, variable->number_value);
+        default:
+            number_value = variable->number_value;
+        }
+        if (is_delta && !is_keyframe) {
+            const bool has_changed = variable->type == number
+                                         ? std::isnan(number_value) != std::isnan(element.last_number) ||
+                                               std::fabs(number_value - element.last_number) > element.deadband
+                                         : integer_value != element.last_integer;
+            if (!has_changed) {
+                continue;
+            }
+        }
+        if (is_delta) {
+            bitmask[i / 8] |= 1 << (i % 8);
+            element.last_integer = integer_value;
+            element.last_number = number_value;
+            has_changes = true;
+        }
+
+        switch (variable->type) {
+        case boolean:
+            payload[pos++] = integer_value;
             break;
-        case string:
-            pos += sprintf(&output_buffer[pos], "\"%s\"", variable->string_value.c_str());
+        case integer:
+            memcpy(&payload[pos], &integer_value, 8);
+            pos += 8;
             break;
         default:
-            throw std::runtime_error("invalid type");
+            memcpy(&payload[pos], &number_value, 4);
+            pos += 4;
         }
     }
+    if (is_delta && !has_changes && !is_keyframe) {
+        return;
+    }
+    if (is_delta) {
+        this->delta_sequence++;
+    }
+    const uint16_t crc = crc16(payload, pos);
+    payload[pos++] = crc & 0xff;
+    payload[pos++] = crc >> 8;
+
+    size_t length = 0;
+    frame[length++] = 0;
+    length += cobs_encode(payload, pos, &frame[length]);
+    frame[length++] = 0;
+    write_telemetry(frame, length);
+}
+
+std::string Core::get_output() const {
+    if (this->is_binary_output || !this->output_plan.is_resolved) {
+        return "";
+    }
+    static char output_buffer[1024];
+    print_output_plan(this->output_plan, output_buffer);
     return std::string(output_buffer);
 }
 
 void Core::keep_alive() {
     this->last_message_millis = millis();
+}
+
+void Core::write_property(const std::string property_name, const ConstExpression_ptr expression, const bool from_expander) {
+    if (property_name == "rate" && expression->is_numbery()) {
+        const number_t rate = expression->evaluate_number();
+        if (rate <= 0 || rate > 1000) {
+            throw std::runtime_error("rate must be between 0 and 1000 Hz");
+        }
+    }
+    Module::write_property(property_name, expression, from_expander);
+}
+
+static void notify_main_loop(void *arg) {
+    xTaskNotify(static_cast<TaskHandle_t>(arg), MAIN_TASK_LOOP_TIMER_BIT, eSetBits);
+}
+
+void Core::start_loop_timer() {
+    if (!this->loop_timer) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = notify_main_loop,
+            .arg = xTaskGetCurrentTaskHandle(),
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "main_loop",
+            .skip_unhandled_events = true,
+        };
+        if (esp_timer_create(&timer_args, &this->loop_timer) != ESP_OK) {
+            this->loop_timer = nullptr;
+            throw std::runtime_error("could not create loop timer");
+        }
+    } else {
+        esp_timer_stop(this->loop_timer);
+    }
+    const Variable_ptr &rate = this->property(PropertyId::rate);
+    if (esp_timer_start_periodic(this->loop_timer, 1000000 / rate->number_value) != ESP_OK) {
+        throw std::runtime_error("could not start loop timer");
+    }
+    this->loop_rate_generation = rate->generation;
+    this->cycle_start_micros = 0;
+}
+
+bool Core::wait_for_next_cycle() {
+    const Variable_ptr &rate = this->property(PropertyId::rate);
+    const unsigned long int period_micros = 1000000 / rate->number_value;
+    if (!this->is_waiting) {
+        if (this->cycle_start_micros && micros_since(this->cycle_start_micros) > period_micros) {
+            this->property(PropertyId::loop_overruns)->set_integer(this->property(PropertyId::loop_overruns)->integer_value + 1);
+        }
+        if ((!this->loop_timer && !this->has_loop_timer_error) || rate->generation != this->loop_rate_generation) {
+            try {
+                this->start_loop_timer();
+                this->has_loop_timer_error = false;
+            } catch (const std::runtime_error &e) {
+                echo("error in main loop timer: %s, waiting with delays instead", e.what());
+                this->has_loop_timer_error = true;
+                this->loop_rate_generation = rate->generation;
+            }
+        }
+        this->is_waiting = true;
+    }
+
+    if (this->has_loop_timer_error) {
+        delay(std::max(period_micros / 1000, 1UL));
+    } else {
+        uint32_t notification_bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &notification_bits, portMAX_DELAY);
+        if (!(notification_bits & MAIN_TASK_LOOP_TIMER_BIT)) {
+            return false;
+        }
+    }
+    this->is_waiting = false;
+
+    const unsigned long int now = micros();
+    if (this->cycle_start_micros) {
+        const unsigned long int actual_period_micros = now - this->cycle_start_micros;
+        const number_t jitter_micros = std::abs((number_t)actual_period_micros - (number_t)period_micros);
+        this->property(PropertyId::loop_period)->set_number(actual_period_micros / 1000.0);
+        if (jitter_micros / 1000.0 > this->property(PropertyId::loop_jitter_max)->number_value) {
+            this->property(PropertyId::loop_jitter_max)->set_number(jitter_micros / 1000.0);
+        }
+    }
+    this->cycle_start_micros = now;
+    this->cycle++;
+    return true;
+}
+
+unsigned int Core::get_cycle() const {
+    return this->cycle;
+}
+
+number_t Core::get_rate() const {
+    return this->property(PropertyId::rate)->number_value;
 }
\ No newline at end of file
@@ -1,13 +1,46 @@
 #pragma once
 
+#include "esp_timer.h"
 #include "module.h"
+#include <map>
 #include <memory>
 #include <utility>
 
+#define MAIN_TASK_LOOP_TIMER_BIT 0x01
+#define MAIN_TASK_UART_BIT 0x02
+
 struct output_element_t {
-    const ConstModule_ptr module;
-    const std::string property_name;
-    const unsigned int precision;
+    ConstModule_ptr module;
+    std::string property_name;
+    unsigned int precision;
+    bool is_round_trip;
+    ConstVariable_ptr variable;
+};
+
+struct output_plan_t {
+    std::vector<struct output_element_t> elements;
+    bool is_resolved = false;
+    unsigned int generation = 0;
+};
+
+struct subscription_t {
+    struct output_plan_t plan;
+    number_t rate;
+};
+
+struct watch_t {
+    std::string name;
+    ConstVariable_ptr variable;
+    number_t deadband;
+    unsigned int generation;
+    number_t last_value;
+};
+
+struct binary_output_element_t {
+    ConstVariable_ptr variable;
+    float deadband;
+    int64_t last_integer;
+    float last_number;
 };
 
 class Core;
@@ -15,15 +48,79 @@ using Core_ptr = std::shared_ptr<Core>;
 
 class Core : public Module {
 private:
-    std::list<struct output_element_t> output_list;
+    enum class MethodId : unsigned int {
+        restart = Module::method_count,
+        version,
+        info,
+        print,
+        output,
+        startup_checksum,
+        ota,
+        output_binary,
+        subscribe,
+        unsubscribe,
+        watch,
+        unwatch,
+        baud,
+        confirm_baud,
+        count,
+    };
+    static const std::vector<Method> methods;
+    enum class PropertyId : unsigned int {
+        debug,
+        millis,
+        heap,
+        last_message_age,
+        rules_evaluated,
+        rules_skipped,
+        cache_size,
+        cache_hit_rate,
+        cache_hit_latency,
+        rate,
+        loop_period,
+        loop_jitter_max,
+        loop_overruns,
+        tx_queued,
+        tx_dropped,
+        count,
+    };
+    static const std::vector<Property> property_table;
+    struct output_plan_t output_plan;
+    std::map<std::string, struct subscription_t> subscriptions;
+    std::vector<struct watch_t> watches;
+    uint32_t unconfirmed_baud_rate = 0;
+    unsigned long int baud_switch_millis = 0;
+    std::vector<struct binary_output_element_t> binary_output_list;
+    bool is_binary_output = false;
+    uint8_t binary_schema_id = 0;
+    unsigned int keyframe_interval = 0;
+    unsigned int frames_since_keyframe = 0;
+    uint8_t delta_sequence = 0;
     unsigned long int last_message_millis = 0;
+    esp_timer_handle_t loop_timer = nullptr;
+    unsigned int loop_rate_generation = 0;
+    bool has_loop_timer_error = false;
+    unsigned long int cycle_start_micros = 0;
+    unsigned int cycle = 0;
+    bool is_waiting = false;
+
+    void start_loop_timer();
+    void write_subscriptions();
+    void write_binary_output();
 
 public:
     Core(const std::string name);
     void step() override;
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Property> &get_property_table() const override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
     double get(const std::string property_name) const;
     void set(std::string property_name, double value);
     std::string get_output() const override;
+    void write_property(const std::string property_name, const ConstExpression_ptr expression, const bool from_expander) override;
     void keep_alive();
+    bool wait_for_next_cycle();
+    void check_watches();
+    unsigned int get_cycle() const;
+    number_t get_rate() const;
 };
\ No newline at end of file
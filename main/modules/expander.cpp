@@ -55,13 +55,34 @@ void Expander::step() {
     Module::step();
 }
 
-void Expander::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (method_name == "run") {
-        Module::expect(arguments, 1, string);
+const std::vector<Method> Expander::methods = create_method_table<Module::method_count, MethodId::forwarded>({
+    {"run", {string}},
+    {"disconnect"},
+    {"flash"},
+});
+
+const std::vector<Method> &Expander::get_methods() const {
+    return Expander::methods;
+}
+
+unsigned int Expander::find_method(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) const {
+    for (unsigned int i = 0; i < Expander::methods.size(); ++i) {
+        if (Expander::methods[i].name == method_name) {
+            Expander::methods[i].expect(arguments);
+            return Module::method_count + i;
+        }
+    }
+    return static_cast<unsigned int>(MethodId::forwarded) + Module::intern_method_name(method_name);
+}
+
+void Expander::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::run: {
         std::string command = arguments[0]->evaluate_string();
         this->serial->write_checked_line(command.c_str(), command.length());
-    } else if (method_name == "disconnect") {
-        Module::expect(arguments, 0);
+        break;
+    }
+    case MethodId::disconnect:
         this->serial->deinstall();
         if (this->boot_pin != GPIO_NUM_NC && this->enable_pin != GPIO_NUM_NC) {
             gpio_reset_pin(this->boot_pin);
@@ -71,8 +92,8 @@ void Expander::call(const std::string method_name, const std::vector<ConstExpres
             gpio_set_pull_mode(this->boot_pin, GPIO_FLOATING);
             gpio_set_pull_mode(this->enable_pin, GPIO_FLOATING);
         }
-    } else if (method_name == "flash") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::flash: {
         if (this->boot_pin == GPIO_NUM_NC || this->enable_pin == GPIO_NUM_NC) {
             throw std::runtime_error("expander \"" + this->name + "\" does not support flashing, pins not set");
         }
@@ -88,11 +109,15 @@ void Expander::call(const std::string method_name, const std::vector<ConstExpres
         if (!success) {
             throw std::runtime_error("could not flash expander \"" + this->name + "\"");
         }
-    } else {
+        break;
+    }
+    default: {
         static char buffer[1024];
+        const std::string &method_name = Module::interned_method_names.at(method_id - static_cast<unsigned int>(MethodId::forwarded));
         int pos = std::sprintf(buffer, "core.%s(", method_name.c_str());
         pos += write_arguments_to_buffer(arguments, &buffer[pos]);
         pos += std::sprintf(&buffer[pos], ")");
         this->serial->write_checked_line(buffer, pos);
     }
+    }
 }
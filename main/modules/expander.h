@@ -8,6 +8,15 @@ class Expander;
 using Expander_ptr = std::shared_ptr<Expander>;
 
 class Expander : public Module {
+private:
+    enum class MethodId : unsigned int {
+        run = Module::method_count,
+        disconnect,
+        flash,
+        forwarded,
+    };
+    static const std::vector<Method> methods;
+
 public:
     const ConstSerial_ptr serial;
     const gpio_num_t boot_pin;
@@ -20,5 +29,7 @@ public:
              const gpio_num_t enable_pin,
              MessageHandler message_handler);
     void step() override;
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Method> &get_methods() const override;
+    unsigned int find_method(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
 };
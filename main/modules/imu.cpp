@@ -1,8 +1,30 @@
 #include "imu.h"
+#include "../utils/io_task.h"
 
 #define I2C_MASTER_TX_BUF_DISABLE 0
 #define I2C_MASTER_RX_BUF_DISABLE 0
 
+const std::vector<Property> Imu::property_table = create_property_table<PropertyId::count>({
+    {"acc_x", number},
+    {"acc_y", number},
+    {"acc_z", number},
+    {"roll", number},
+    {"pitch", number},
+    {"yaw", number},
+    {"quat_w", number},
+    {"quat_x", number},
+    {"quat_y", number},
+    {"quat_z", number},
+    {"cal_sys", number},
+    {"cal_gyr", number},
+    {"cal_acc", number},
+    {"cal_mag", number},
+});
+
+const std::vector<Property> &Imu::get_property_table() const {
+    return Imu::property_table;
+}
+
 Imu::Imu(const std::string name, i2c_port_t i2c_port, gpio_num_t sda_pin, gpio_num_t scl_pin, uint8_t address, int clk_speed)
     : Module(imu, name), i2c_port(i2c_port), address(address) {
     i2c_config_t config;
@@ -32,44 +54,71 @@ Imu::Imu(const std::string name, i2c_port_t i2c_port, gpio_num_t sda_pin, gpio_n
     } catch (std::exception &ex) {
         throw std::runtime_error(std::string("imu setup failed: ") + ex.what());
     }
-    this->properties["acc_x"] = std::make_shared<NumberVariable>();
-    this->properties["acc_y"] = std::make_shared<NumberVariable>();
-    this->properties["acc_z"] = std::make_shared<NumberVariable>();
-    this->properties["roll"] = std::make_shared<NumberVariable>();
-    this->properties["pitch"] = std::make_shared<NumberVariable>();
-    this->properties["yaw"] = std::make_shared<NumberVariable>();
-    this->properties["quat_w"] = std::make_shared<NumberVariable>();
-    this->properties["quat_x"] = std::make_shared<NumberVariable>();
-    this->properties["quat_y"] = std::make_shared<NumberVariable>();
-    this->properties["quat_z"] = std::make_shared<NumberVariable>();
-    this->properties["cal_sys"] = std::make_shared<NumberVariable>();
-    this->properties["cal_gyr"] = std::make_shared<NumberVariable>();
-    this->properties["cal_acc"] = std::make_shared<NumberVariable>();
-    this->properties["cal_mag"] = std::make_shared<NumberVariable>();
+    this->create_properties();
 }
 
-void Imu::step() {
-    bno055_vector_t v = this->bno->getVectorAccelerometer();
-    this->properties.at("acc_x")->number_value = v.x;
-    this->properties.at("acc_y")->number_value = v.y;
-    this->properties.at("acc_z")->number_value = v.z;
+imu_sample_t Imu::read_sample() const {
+    imu_sample_t sample;
+    sample.acceleration = this->bno->getVectorAccelerometer();
+    sample.euler = this->bno->getVectorEuler();
+    sample.quaternion = this->bno->getQuaternion();
+    sample.calibration = this->bno->getCalibration();
+    return sample;
+}
 
-    bno055_vector_t e = this->bno->getVectorEuler();
-    this->properties.at("yaw")->number_value = e.x;
-    this->properties.at("roll")->number_value = e.y;
-    this->properties.at("pitch")->number_value = e.z;
+void Imu::publish(const imu_sample_t &sample) {
+    this->property(PropertyId::acc_x)->set_number(sample.acceleration.x);
+    this->property(PropertyId::acc_y)->set_number(sample.acceleration.y);
+    this->property(PropertyId::acc_z)->set_number(sample.acceleration.z);
 
-    bno055_quaternion_t q = this->bno->getQuaternion();
-    this->properties.at("quat_w")->number_value = q.w;
-    this->properties.at("quat_x")->number_value = q.x;
-    this->properties.at("quat_y")->number_value = q.y;
-    this->properties.at("quat_z")->number_value = q.z;
+    this->property(PropertyId::yaw)->set_number(sample.euler.x);
+    this->property(PropertyId::roll)->set_number(sample.euler.y);
+    this->property(PropertyId::pitch)->set_number(sample.euler.z);
 
-    bno055_calibration_t c = this->bno->getCalibration();
-    this->properties.at("cal_sys")->number_value = c.sys;
-    this->properties.at("cal_gyr")->number_value = c.gyro;
-    this->properties.at("cal_acc")->number_value = c.accel;
-    this->properties.at("cal_mag")->number_value = c.mag;
+    this->property(PropertyId::quat_w)->set_number(sample.quaternion.w);
+    this->property(PropertyId::quat_x)->set_number(sample.quaternion.x);
+    this->property(PropertyId::quat_y)->set_number(sample.quaternion.y);
+    this->property(PropertyId::quat_z)->set_number(sample.quaternion.z);
+
+    this->property(PropertyId::cal_sys)->set_number(sample.calibration.sys);
+    this->property(PropertyId::cal_gyr)->set_number(sample.calibration.gyro);
+    this->property(PropertyId::cal_acc)->set_number(sample.calibration.accel);
+    this->property(PropertyId::cal_mag)->set_number(sample.calibration.mag);
+}
+
+#ifdef CONFIG_LIZARD_BUS_IO_TASKS
+void Imu::run_poll_task(void *arg) {
+    Imu *const imu = static_cast<Imu *>(arg);
+    while (true) {
+        try {
+            imu->sample_queue.push(imu->read_sample());
+        } catch (const std::exception &) {
+            imu->poll_error_count++;
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+#endif
+
+void Imu::step() {
+#ifdef CONFIG_LIZARD_BUS_IO_TASKS
+    if (!this->poll_task) {
+        this->poll_task = start_io_task(Imu::run_poll_task, "imu_poll", this);
+    }
+    imu_sample_t sample;
+    bool has_sample = false;
+    while (this->sample_queue.pop(sample)) {
+        has_sample = true;
+    }
+    if (has_sample) {
+        this->publish(sample);
+    }
+    if (this->poll_error_count.exchange(0) > 0) {
+        throw std::runtime_error("could not read imu");
+    }
+#else
+    this->publish(this->read_sample());
+#endif
 
     Module::step();
-}
\ No newline at end of file
+}
@@ -1,21 +1,61 @@
 #pragma once
 
+#include "../utils/spsc_queue.h"
 #include "BNO055ESP32.h"
 #include "driver/i2c.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "module.h"
+#include <atomic>
 
 class Imu;
 using Imu_ptr = std::shared_ptr<Imu>;
 
 using Bno_ptr = std::shared_ptr<BNO055>;
 
+struct imu_sample_t {
+    bno055_vector_t acceleration;
+    bno055_vector_t euler;
+    bno055_quaternion_t quaternion;
+    bno055_calibration_t calibration;
+};
+
 class Imu : public Module {
 private:
+    enum class PropertyId : unsigned int {
+        acc_x,
+        acc_y,
+        acc_z,
+        roll,
+        pitch,
+        yaw,
+        quat_w,
+        quat_x,
+        quat_y,
+        quat_z,
+        cal_sys,
+        cal_gyr,
+        cal_acc,
+        cal_mag,
+        count,
+    };
+    static const std::vector<Property> property_table;
     const i2c_port_t i2c_port;
     const uint8_t address;
     Bno_ptr bno;
+#ifdef CONFIG_LIZARD_BUS_IO_TASKS
+    SpscQueue<imu_sample_t> sample_queue{4};
+    std::atomic<unsigned int> poll_error_count{0};
+    TaskHandle_t poll_task = nullptr;
+
+    static void run_poll_task(void *arg);
+#endif
+
+    imu_sample_t read_sample() const;
+    void publish(const imu_sample_t &sample);
 
 public:
     Imu(const std::string name, i2c_port_t i2c_port, gpio_num_t sda_pin, gpio_num_t scl_pin, uint8_t address, int clk_speed);
+    const std::vector<Property> &get_property_table() const override;
     void step() override;
 };
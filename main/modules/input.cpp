@@ -2,36 +2,56 @@
 #include "../utils/uart.h"
 #include <memory>
 
+const std::vector<Property> Input::property_table = create_property_table<PropertyId::count>({
+    {"level", integer},
+    {"change", integer},
+    {"inverted", boolean},
+    {"active", boolean},
+});
+
+const std::vector<Property> &Input::get_property_table() const {
+    return Input::property_table;
+}
+
 Input::Input(const std::string name) : Module(input, name) {
-    this->properties["level"] = std::make_shared<IntegerVariable>();
-    this->properties["change"] = std::make_shared<IntegerVariable>();
-    this->properties["inverted"] = std::make_shared<BooleanVariable>();
-    this->properties["active"] = std::make_shared<BooleanVariable>();
+    this->create_properties();
 }
 
 void Input::step() {
     const int new_level = this->get_level();
-    this->properties.at("change")->integer_value = new_level - this->properties.at("level")->integer_value;
-    this->properties.at("level")->integer_value = new_level;
-    this->properties.at("active")->boolean_value = this->properties.at("inverted")->boolean_value ? !new_level : new_level;
+    this->property(PropertyId::change)->set_integer(new_level - this->property(PropertyId::level)->integer_value);
+    this->property(PropertyId::level)->set_integer(new_level);
+    this->property(PropertyId::active)->set_boolean(this->property(PropertyId::inverted)->boolean_value ? !new_level : new_level);
     Module::step();
 }
 
-void Input::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (method_name == "get") {
-        Module::expect(arguments, 0);
+const std::vector<Method> Input::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"get"},
+    {"pullup"},
+    {"pulldown"},
+    {"pulloff"},
+});
+
+const std::vector<Method> &Input::get_methods() const {
+    return Input::methods;
+}
+
+void Input::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::get:
         echo("%s %d", this->name.c_str(), this->get_level());
-    } else if (method_name == "pullup") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::pullup:
         this->set_pull_mode(GPIO_PULLUP_ONLY);
-    } else if (method_name == "pulldown") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::pulldown:
         this->set_pull_mode(GPIO_PULLDOWN_ONLY);
-    } else if (method_name == "pulloff") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::pulloff:
         this->set_pull_mode(GPIO_FLOATING);
-    } else {
-        Module::call(method_name, arguments);
+        break;
+    default:
+        Module::call(method_id, arguments);
     }
 }
 
@@ -45,7 +65,7 @@ GpioInput::GpioInput(const std::string name, const gpio_num_t number)
     : Input(name), number(number) {
     gpio_reset_pin(number);
     gpio_set_direction(number, GPIO_MODE_INPUT);
-    this->properties.at("level")->integer_value = this->get_level();
+    this->property(PropertyId::level)->set_integer(this->get_level());
 }
 
 bool GpioInput::get_level() const {
@@ -59,7 +79,7 @@ void GpioInput::set_pull_mode(const gpio_pull_mode_t mode) const {
 McpInput::McpInput(const std::string name, const Mcp23017_ptr mcp, const uint8_t number)
     : Input(name), mcp(mcp), number(number) {
     this->mcp->set_input(this->number, true);
-    this->properties.at("level")->integer_value = this->get_level();
+    this->property(PropertyId::level)->set_integer(this->get_level());
 }
 
 bool McpInput::get_level() const {
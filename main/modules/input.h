@@ -9,14 +9,32 @@ using Input_ptr = std::shared_ptr<Input>;
 
 class Input : public Module {
 private:
+    enum class MethodId : unsigned int {
+        get = Module::method_count,
+        pullup,
+        pulldown,
+        pulloff,
+        count,
+    };
+    static const std::vector<Method> methods;
+    static const std::vector<Property> property_table;
     virtual void set_pull_mode(const gpio_pull_mode_t mode) const = 0;
 
 protected:
+    enum class PropertyId : unsigned int {
+        level,
+        change,
+        inverted,
+        active,
+        count,
+    };
     Input(const std::string name);
 
 public:
     void step() override;
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Property> &get_property_table() const override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
     std::string get_output() const override;
     virtual bool get_level() const = 0;
 };
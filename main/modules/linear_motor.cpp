@@ -1,32 +1,51 @@
 #include "linear_motor.h"
 #include <memory>
 
+const std::vector<Property> LinearMotor::property_table = create_property_table<PropertyId::count>({
+    {"in", boolean},
+    {"out", boolean},
+});
+
+const std::vector<Property> &LinearMotor::get_property_table() const {
+    return LinearMotor::property_table;
+}
+
 LinearMotor::LinearMotor(const std::string name) : Module(output, name) {
-    this->properties["in"] = std::make_shared<BooleanVariable>();
-    this->properties["out"] = std::make_shared<BooleanVariable>();
+    this->create_properties();
 }
 
 void LinearMotor::step() {
-    this->properties.at("in")->boolean_value = this->get_in();
-    this->properties.at("out")->boolean_value = this->get_out();
+    this->property(PropertyId::in)->set_boolean(this->get_in());
+    this->property(PropertyId::out)->set_boolean(this->get_out());
     Module::step();
 }
 
-void LinearMotor::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (method_name == "in") {
-        Module::expect(arguments, 0);
+const std::vector<Method> LinearMotor::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"in"},
+    {"out"},
+    {"stop"},
+});
+
+const std::vector<Method> &LinearMotor::get_methods() const {
+    return LinearMotor::methods;
+}
+
+void LinearMotor::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::in:
         this->set_in(1);
         this->set_out(0);
-    } else if (method_name == "out") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::out:
         this->set_in(0);
         this->set_out(1);
-    } else if (method_name == "stop") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::stop:
         this->set_in(0);
         this->set_out(0);
-    } else {
-        Module::call(method_name, arguments);
+        break;
+    default:
+        Module::call(method_id, arguments);
     }
 }
 
@@ -44,8 +63,8 @@ GpioLinearMotor::GpioLinearMotor(const std::string name,
     gpio_set_direction(move_out, GPIO_MODE_OUTPUT);
     gpio_set_direction(end_in, GPIO_MODE_INPUT);
     gpio_set_direction(end_out, GPIO_MODE_INPUT);
-    this->properties.at("in")->boolean_value = this->get_in();
-    this->properties.at("out")->boolean_value = this->get_out();
+    this->property(PropertyId::in)->set_boolean(this->get_in());
+    this->property(PropertyId::out)->set_boolean(this->get_out());
 }
 
 bool GpioLinearMotor::get_in() const {
@@ -75,8 +94,8 @@ McpLinearMotor::McpLinearMotor(const std::string name,
     this->mcp->set_input(this->move_out, false);
     this->mcp->set_input(this->end_in, true);
     this->mcp->set_input(this->end_out, true);
-    this->properties.at("in")->boolean_value = this->get_in();
-    this->properties.at("out")->boolean_value = this->get_out();
+    this->property(PropertyId::in)->set_boolean(this->get_in());
+    this->property(PropertyId::out)->set_boolean(this->get_out());
 }
 
 bool McpLinearMotor::get_in() const {
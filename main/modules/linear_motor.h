@@ -6,17 +6,32 @@
 
 class LinearMotor : public Module {
 private:
+    enum class MethodId : unsigned int {
+        in = Module::method_count,
+        out,
+        stop,
+        count,
+    };
+    static const std::vector<Method> methods;
+    static const std::vector<Property> property_table;
     virtual bool get_in() const = 0;
     virtual bool get_out() const = 0;
     virtual void set_in(bool level) const = 0;
     virtual void set_out(bool level) const = 0;
 
 protected:
+    enum class PropertyId : unsigned int {
+        in,
+        out,
+        count,
+    };
     LinearMotor(const std::string name);
 
 public:
     void step() override;
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Property> &get_property_table() const override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
 };
 
 class GpioLinearMotor : public LinearMotor {
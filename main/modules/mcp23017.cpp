@@ -3,6 +3,16 @@
 #define I2C_MASTER_TX_BUF_DISABLE 0
 #define I2C_MASTER_RX_BUF_DISABLE 0
 
+const std::vector<Property> Mcp23017::property_table = create_property_table<PropertyId::count>({
+    {"levels", integer},
+    {"inputs", integer},
+    {"pullups", integer},
+});
+
+const std::vector<Property> &Mcp23017::get_property_table() const {
+    return Mcp23017::property_table;
+}
+
 Mcp23017::Mcp23017(const std::string name, i2c_port_t i2c_port, gpio_num_t sda_pin, gpio_num_t scl_pin, uint8_t address, int clk_speed)
     : Module(mcp23017, name), i2c_port(i2c_port), address(address) {
     i2c_config_t config;
@@ -20,37 +30,50 @@ Mcp23017::Mcp23017(const std::string name, i2c_port_t i2c_port, gpio_num_t sda_p
         throw std::runtime_error("could not install i2c driver");
     }
 
-    this->properties["levels"] = std::make_shared<IntegerVariable>();
-    this->properties["inputs"] = std::make_shared<IntegerVariable>(0xffff); // default: all pins input
-    this->properties["pullups"] = std::make_shared<IntegerVariable>();
+    this->create_properties();
+    this->property(PropertyId::inputs)->set_integer(0xffff); // default: all pins input
 
-    this->set_inputs(this->properties.at("inputs")->integer_value);
-    this->set_pullups(this->properties.at("pullups")->integer_value);
+    this->set_inputs(this->property(PropertyId::inputs)->integer_value);
+    this->set_pullups(this->property(PropertyId::pullups)->integer_value);
 }
 
 void Mcp23017::step() {
-    this->properties.at("levels")->integer_value = this->read_pins();
+    this->property(PropertyId::levels)->set_integer(this->read_pins());
     Module::step();
 }
 
-void Mcp23017::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (method_name == "levels") {
-        Module::expect(arguments, 1, integer);
+const std::vector<Method> Mcp23017::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"levels", {integer}},
+    {"pullups", {integer}},
+    {"inputs", {integer}},
+});
+
+const std::vector<Method> &Mcp23017::get_methods() const {
+    return Mcp23017::methods;
+}
+
+void Mcp23017::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::levels: {
         const uint16_t value = arguments[0]->evaluate_integer();
-        this->properties.at("levels")->integer_value = value;
+        this->property(PropertyId::levels)->set_integer(value);
         this->write_pins(value);
-    } else if (method_name == "pullups") {
-        Module::expect(arguments, 1, integer);
+        break;
+    }
+    case MethodId::pullups: {
         const uint16_t value = arguments[0]->evaluate_integer();
-        this->properties.at("pullups")->integer_value = value;
+        this->property(PropertyId::pullups)->set_integer(value);
         this->set_pullups(value);
-    } else if (method_name == "inputs") {
-        Module::expect(arguments, 1, integer);
+        break;
+    }
+    case MethodId::inputs: {
         const uint16_t value = arguments[0]->evaluate_integer();
-        this->properties.at("inputs")->integer_value = value;
+        this->property(PropertyId::inputs)->set_integer(value);
         this->set_inputs(value);
-    } else {
-        Module::call(method_name, arguments);
+        break;
+    }
+    default:
+        Module::call(method_id, arguments);
     }
 }
 
@@ -115,38 +138,38 @@ void Mcp23017::set_pullups(uint16_t pullups) const {
 }
 
 bool Mcp23017::get_level(const uint8_t number) const {
-    return this->properties.at("levels")->integer_value & (1 << number);
+    return this->property(PropertyId::levels)->integer_value & (1 << number);
 }
 
 void Mcp23017::set_level(const uint8_t number, const bool value) const {
-    uint16_t levels = this->properties.at("levels")->integer_value;
+    uint16_t levels = this->property(PropertyId::levels)->integer_value;
     if (value) {
         levels |= 1 << number;
     } else {
         levels &= ~(1 << number);
     }
-    this->properties.at("levels")->integer_value = levels;
+    this->property(PropertyId::levels)->set_integer(levels);
     this->write_pins(levels);
 }
 
 void Mcp23017::set_input(const uint8_t number, const bool value) const {
-    uint16_t inputs = this->properties.at("inputs")->integer_value;
+    uint16_t inputs = this->property(PropertyId::inputs)->integer_value;
     if (value) {
         inputs |= 1 << number;
     } else {
         inputs &= ~(1 << number);
     }
-    this->properties.at("inputs")->integer_value = inputs;
+    this->property(PropertyId::inputs)->set_integer(inputs);
     this->set_inputs(inputs);
 }
 
 void Mcp23017::set_pullup(const uint8_t number, const bool value) const {
-    uint16_t pullups = this->properties.at("pullups")->integer_value;
+    uint16_t pullups = this->property(PropertyId::pullups)->integer_value;
     if (value) {
         pullups |= 1 << number;
     } else {
         pullups &= ~(1 << number);
     }
-    this->properties.at("pullups")->integer_value = pullups;
+    this->property(PropertyId::pullups)->set_integer(pullups);
     this->set_pullups(pullups);
 }
@@ -17,6 +17,20 @@ using Mcp23017_ptr = std::shared_ptr<Mcp23017>;
 
 class Mcp23017 : public Module {
 private:
+    enum class MethodId : unsigned int {
+        levels = Module::method_count,
+        pullups,
+        inputs,
+        count,
+    };
+    static const std::vector<Method> methods;
+    enum class PropertyId : unsigned int {
+        levels,
+        inputs,
+        pullups,
+        count,
+    };
+    static const std::vector<Property> property_table;
     const i2c_port_t i2c_port;
     const uint8_t address;
 
@@ -30,7 +44,9 @@ private:
 public:
     Mcp23017(const std::string name, i2c_port_t i2c_port, gpio_num_t sda_pin, gpio_num_t scl_pin, uint8_t address, int clk_speed);
     void step() override;
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Property> &get_property_table() const override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
 
     bool get_level(const uint8_t number) const;
     void set_level(const uint8_t number, const bool value) const;
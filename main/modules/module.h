@@ -22,6 +22,7 @@ enum ModuleType {
     odrive_wheels,
     rmd_motor,
     rmd_pair,
+    rmd_group,
     roboclaw,
     roboclaw_motor,
     roboclaw_wheels,
@@ -38,16 +39,64 @@ using Module_ptr = std::shared_ptr<Module>;
 using ConstModule_ptr = std::shared_ptr<const Module>;
 using MessageHandler = void (*)(const char *line, bool trigger_keep_alive, bool from_expander);
 
+struct Method {
+    const std::string name;
+    const size_t min_arguments;
+    const size_t max_arguments;
+    const std::vector<Type> types;
+
+    Method(const std::string name, const std::vector<Type> types = {});
+    Method(const std::string name, const int min_arguments, const int max_arguments, const std::vector<Type> types = {});
+    void expect(const std::vector<ConstExpression_ptr> arguments) const;
+};
+
+struct Property {
+    const std::string name;
+    const Type type;
+};
+
 class Module {
 private:
+    enum class MethodId : unsigned int {
+        mute,
+        unmute,
+        broadcast,
+        shadow,
+        count,
+    };
+    static const std::vector<Method> methods;
     std::list<Module_ptr> shadow_modules;
+    const Variable_ptr step_rate = std::make_shared<NumberVariable>(0);
+    const Variable_ptr step_phase = std::make_shared<IntegerVariable>(0);
 
 protected:
-    std::map<std::string, Variable_ptr> properties;
+    static std::vector<std::string> interned_method_names;
+    static unsigned int intern_method_name(const std::string method_name);
+
+    std::vector<Variable_ptr> properties;
     bool output_on = false;
     bool broadcast = false;
 
+    void create_properties();
+    template <typename T>
+    const Variable_ptr &property(const T property_id) const {
+        return this->properties[static_cast<unsigned int>(property_id)];
+    }
+
+    template <unsigned int first, auto count, size_t size>
+    static std::vector<Method> create_method_table(const Method (&table)[size]) {
+        static_assert(static_cast<unsigned int>(count) - first == size, "method table does not match MethodId");
+        return std::vector<Method>(table, table + size);
+    }
+    template <auto count, size_t size>
+    static std::vector<Property> create_property_table(const Property (&table)[size]) {
+        static_assert(static_cast<unsigned int>(count) == size, "property table does not match PropertyId");
+        return std::vector<Property>(table, table + size);
+    }
+
 public:
+    static const unsigned int method_count = static_cast<unsigned int>(MethodId::count);
+
     const ModuleType type;
     const std::string name;
 
@@ -58,9 +107,13 @@ public:
                              const std::vector<ConstExpression_ptr> arguments,
                              MessageHandler message_handler);
     virtual void step();
-    virtual void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments);
-    void call_with_shadows(const std::string method_name, const std::vector<ConstExpression_ptr> arguments);
+    bool is_due(const unsigned int cycle, const number_t loop_rate) const;
+    virtual const std::vector<Method> &get_methods() const;
+    virtual unsigned int find_method(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) const;
+    virtual void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments);
+    void call_with_shadows(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments);
     virtual std::string get_output() const;
+    virtual const std::vector<Property> &get_property_table() const;
     Variable_ptr get_property(const std::string property_name) const;
     virtual void write_property(const std::string property_name, const ConstExpression_ptr expression, const bool from_expander = false);
     virtual void handle_can_msg(const uint32_t id, const int count, const uint8_t *const data);
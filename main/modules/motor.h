@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../compilation/type.h"
 #include <memory>
 #include <stdint.h>
 
@@ -9,8 +10,8 @@ using Motor_ptr = std::shared_ptr<Motor>;
 class Motor {
 public:
     virtual void stop() = 0;
-    virtual double get_position() = 0;
-    virtual void position(const double position, const double speed, const double acceleration) = 0;
-    virtual double get_speed() = 0;
-    virtual void speed(const double speed, const double acceleration) = 0;
+    virtual number_t get_position() = 0;
+    virtual void position(const number_t position, const number_t speed, const number_t acceleration) = 0;
+    virtual number_t get_speed() = 0;
+    virtual void speed(const number_t speed, const number_t acceleration) = 0;
 };
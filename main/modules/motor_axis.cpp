@@ -2,14 +2,15 @@
 #include "utils/uart.h"
 
 MotorAxis::MotorAxis(const std::string name, const Motor_ptr motor, const Input_ptr input1, const Input_ptr input2)
-    : Module(motor_axis, name), motor(motor), input1(input1), input2(input2) {
+    : Module(motor_axis, name), motor(motor),
+      input1_active(input1->get_property("active")), input2_active(input2->get_property("active")) {
 }
 
 bool MotorAxis::can_move(const float speed) const {
-    if (speed < 0 && this->input1->get_property("active")->boolean_value) {
+    if (speed < 0 && this->input1_active->boolean_value) {
         return false;
     }
-    if (speed > 0 && this->input2->get_property("active")->boolean_value) {
+    if (speed > 0 && this->input2_active->boolean_value) {
         return false;
     }
     return true;
@@ -23,12 +24,19 @@ void MotorAxis::step() {
     Module::step();
 }
 
-void MotorAxis::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (method_name == "position") {
-        if (arguments.size() < 2 || arguments.size() > 3) {
-            throw std::runtime_error("unexpected number of arguments");
-        }
-        Module::expect(arguments, -1, numbery, numbery, numbery);
+const std::vector<Method> MotorAxis::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"position", 2, 3, {numbery, numbery, numbery}},
+    {"speed", 1, 2, {numbery, numbery}},
+    {"stop"},
+});
+
+const std::vector<Method> &MotorAxis::get_methods() const {
+    return MotorAxis::methods;
+}
+
+void MotorAxis::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::position: {
         // Check distance because speed is always positive for ODriveMotors in position mode
         float distance = arguments[0]->evaluate_number() - this->motor->get_position();
         if (this->can_move(distance)) {
@@ -36,21 +44,21 @@ void MotorAxis::call(const std::string method_name, const std::vector<ConstExpre
         } else {
             this->motor->stop();
         }
-    } else if (method_name == "speed") {
-        if (arguments.size() < 1 || arguments.size() > 2) {
-            throw std::runtime_error("unexpected number of arguments");
-        }
-        Module::expect(arguments, -1, numbery, numbery);
+        break;
+    }
+    case MethodId::speed: {
         float speed = arguments[0]->evaluate_number();
         if (this->can_move(speed)) {
             this->motor->speed(speed, arguments.size() > 1 ? std::abs(arguments[1]->evaluate_number()) : 0);
         } else {
             this->motor->stop();
         }
-    } else if (method_name == "stop") {
-        Module::expect(arguments, 0);
+        break;
+    }
+    case MethodId::stop:
         this->motor->stop();
-    } else {
-        Module::call(method_name, arguments);
+        break;
+    default:
+        Module::call(method_id, arguments);
     }
 }
@@ -5,14 +5,22 @@
 
 class MotorAxis : public Module {
 private:
+    enum class MethodId : unsigned int {
+        position = Module::method_count,
+        speed,
+        stop,
+        count,
+    };
+    static const std::vector<Method> methods;
     const Motor_ptr motor;
-    const Input_ptr input1;
-    const Input_ptr input2;
+    const ConstVariable_ptr input1_active;
+    const ConstVariable_ptr input2_active;
 
     bool can_move(const float speed) const;
 
 public:
     MotorAxis(const std::string name, const Motor_ptr motor, const Input_ptr input1, const Input_ptr input2);
     void step() override;
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
 };
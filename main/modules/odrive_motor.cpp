@@ -2,16 +2,25 @@
 #include <cstring>
 #include <memory>
 
+const std::vector<Property> ODriveMotor::property_table = create_property_table<PropertyId::count>({
+    {"position", number},
+    {"speed", number},
+    {"tick_offset", number},
+    {"m_per_tick", number},
+    {"reversed", boolean},
+    {"axis_state", integer},
+    {"axis_error", integer},
+    {"motor_error_flag", integer},
+});
+
+const std::vector<Property> &ODriveMotor::get_property_table() const {
+    return ODriveMotor::property_table;
+}
+
 ODriveMotor::ODriveMotor(const std::string name, const Can_ptr can, const uint32_t can_id, const uint32_t version)
     : Module(odrive_motor, name), can_id(can_id), can(can), version(version) {
-    this->properties["position"] = std::make_shared<NumberVariable>();
-    this->properties["speed"] = std::make_shared<NumberVariable>();
-    this->properties["tick_offset"] = std::make_shared<NumberVariable>();
-    this->properties["m_per_tick"] = std::make_shared<NumberVariable>(1.0);
-    this->properties["reversed"] = std::make_shared<BooleanVariable>();
-    this->properties["axis_state"] = std::make_shared<IntegerVariable>();
-    this->properties["axis_error"] = std::make_shared<IntegerVariable>();
-    this->properties["motor_error_flag"] = std::make_shared<IntegerVariable>();
+    this->create_properties();
+    this->property(PropertyId::m_per_tick)->set_number(1.0);
 }
 
 void ODriveMotor::subscribe_to_can() {
@@ -23,51 +32,62 @@ void ODriveMotor::set_mode(const uint8_t state, const uint8_t control_mode, cons
     if (!this->is_boot_complete) {
         return;
     }
-    if (this->properties.at("motor_error_flag")->number_value == 1) {
-        this->axis_state = -1;
-        this->axis_control_mode = -1;
-        this->axis_input_mode = -1;
-        return;
-    }
     if (this->axis_state != state) {
-        this->can->send(this->can_id + 0x007, state, 0, 0, 0, 0, 0, 0, 0);
+        const CanTxPriority priority = state == 1 ? can_tx_emergency : can_tx_config;
+        this->can->send(this->can_id + 0x007, state, 0, 0, 0, 0, 0, 0, 0, false, priority, this->can_id);
         this->axis_state = state;
     }
     if (this->axis_control_mode != control_mode ||
         this->axis_input_mode != input_mode) {
-        this->can->send(this->can_id + 0x00b, control_mode, 0, 0, 0, input_mode, 0, 0, 0);
+        this->can->send(this->can_id + 0x00b, control_mode, 0, 0, 0, input_mode, 0, 0, 0, false, can_tx_config, this->can_id);
         this->axis_control_mode = control_mode;
         this->axis_input_mode = input_mode;
     }
 }
 
-void ODriveMotor::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (method_name == "zero") {
-        Module::expect(arguments, 0);
-        this->properties.at("tick_offset")->number_value +=
-            this->properties.at("position")->number_value /
-            this->properties.at("m_per_tick")->number_value *
-            (this->properties.at("reversed")->boolean_value ? -1 : 1);
-    } else if (method_name == "power") {
-        Module::expect(arguments, 1, numbery);
+const std::vector<Method> ODriveMotor::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"zero"},
+    {"power", {numbery}},
+    {"speed", {numbery}},
+    {"position", {numbery}},
+    {"limits", {numbery, numbery}},
+    {"off"},
+    {"reset_motor"},
+});
+
+const std::vector<Method> &ODriveMotor::get_methods() const {
+    return ODriveMotor::methods;
+}
+
+void ODriveMotor::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::zero:
+        this->property(PropertyId::tick_offset)->set_number(
+            this->property(PropertyId::tick_offset)->number_value +
+                this->property(PropertyId::position)->number_value /
+                    this->property(PropertyId::m_per_tick)->number_value *
+                    (this->property(PropertyId::reversed)->boolean_value ? -1 : 1));
+        break;
+    case MethodId::power:
         this->power(arguments[0]->evaluate_number());
-    } else if (method_name == "speed") {
-        Module::expect(arguments, 1, numbery);
+        break;
+    case MethodId::speed:
         this->speed(arguments[0]->evaluate_number());
-    } else if (method_name == "position") {
-        Module::expect(arguments, 1, numbery);
+        break;
+    case MethodId::position:
         this->position(arguments[0]->evaluate_number());
-    } else if (method_name == "limits") {
-        Module::expect(arguments, 2, numbery, numbery);
+        break;
+    case MethodId::limits:
         this->limits(arguments[0]->evaluate_number(), arguments[1]->evaluate_number());
-    } else if (method_name == "off") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::off:
         this->off();
-    } else if (method_name == "reset_motor") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::reset_motor:
         this->reset_motor_error();
-    } else {
-        Module::call(method_name, arguments);
+        break;
+    default:
+        Module::call(method_id, arguments);
     }
 }
 
@@ -77,31 +97,32 @@ void ODriveMotor::handle_can_msg(const uint32_t id, const int count, const uint8
     case 0x001: {
         int axis_error;
         std::memcpy(&axis_error, data, 4);
-        this->properties.at("axis_error")->integer_value = axis_error;
+        this->property(PropertyId::axis_error)->set_integer(axis_error);
         int axis_state;
         std::memcpy(&axis_state, data + 4, 1);
         this->axis_state = axis_state;
-        this->properties.at("axis_state")->integer_value = axis_state;
+        this->property(PropertyId::axis_state)->set_integer(axis_state);
         if (version == 6) {
             int message_byte;
             std::memcpy(&message_byte, data + 5, 1);
-            this->properties.at("motor_error_flag")->integer_value = message_byte & 0x01;
+            this->property(PropertyId::motor_error_flag)->set_integer(message_byte & 0x01);
         }
         break;
     }
     case 0x009: {
         float tick;
         std::memcpy(&tick, data, 4);
-        this->properties.at("position")->number_value =
-            (tick - this->properties.at("tick_offset")->number_value) *
-            (this->properties.at("reversed")->boolean_value ? -1 : 1) *
-            this->properties.at("m_per_tick")->number_value;
+        this->precise_position = ((double)tick - this->property(PropertyId::tick_offset)->number_value) *
+                                 (this->property(PropertyId::reversed)->boolean_value ? -1 : 1) *
+                                 this->property(PropertyId::m_per_tick)->number_value;
+        this->property(PropertyId::position)->set_number(this->precise_position);
+        this->position_timestamp = this->can->get_rx_timestamp();
         float ticks_per_second;
         std::memcpy(&ticks_per_second, data + 4, 4);
-        this->properties.at("speed")->number_value =
+        this->property(PropertyId::speed)->set_number(
             ticks_per_second *
-            (this->properties.at("reversed")->boolean_value ? -1 : 1) *
-            this->properties.at("m_per_tick")->number_value;
+            (this->property(PropertyId::reversed)->boolean_value ? -1 : 1) *
+            this->property(PropertyId::m_per_tick)->number_value);
     }
     }
 }
@@ -109,39 +130,39 @@ void ODriveMotor::handle_can_msg(const uint32_t id, const int count, const uint8
 void ODriveMotor::power(const float torque) {
     this->set_mode(8, 1, 1); // AXIS_STATE_CLOSED_LOOP_CONTROL, CONTROL_MODE_TORQUE_CONTROL, INPUT_MODE_PASSTHROUGH
     uint8_t data[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-    int sign = this->properties.at("reversed")->boolean_value ? -1 : 1;
+    int sign = this->property(PropertyId::reversed)->boolean_value ? -1 : 1;
     const float motor_torque = sign * torque;
     std::memcpy(data, &motor_torque, 4);
-    this->can->send(this->can_id + 0x00e, data); // "Set Input Torque"
+    this->can->send(this->can_id + 0x00e, data, false, 8, can_tx_setpoint, this->can_id); // "Set Input Torque"
 }
 
 void ODriveMotor::speed(const float speed) {
     this->set_mode(8, 2, 1); // AXIS_STATE_CLOSED_LOOP_CONTROL, CONTROL_MODE_VELOCITY_CONTROL, INPUT_MODE_PASSTHROUGH
     uint8_t data[8] = {0, 0, 0, 0, 0, 0, 0, 0};
     const float motor_speed = speed /
-                              this->properties.at("m_per_tick")->number_value /
-                              (this->properties.at("reversed")->boolean_value ? -1 : 1);
+                              this->property(PropertyId::m_per_tick)->number_value /
+                              (this->property(PropertyId::reversed)->boolean_value ? -1 : 1);
     std::memcpy(data, &motor_speed, 4);
-    this->can->send(this->can_id + 0x00d, data); // "Set Input Vel"
+    this->can->send(this->can_id + 0x00d, data, false, 8, can_tx_setpoint, this->can_id); // "Set Input Vel"
 }
 
 void ODriveMotor::position(const float position) {
     this->set_mode(8, 3, 1); // AXIS_STATE_CLOSED_LOOP_CONTROL, CONTROL_MODE_POSITION_CONTROL, INPUT_MODE_PASSTHROUGH
     uint8_t pos_data[8] = {0, 0, 0, 0, 0, 0, 0, 0};
     const float motor_position = position /
-                                     (this->properties.at("reversed")->boolean_value ? -1 : 1) /
-                                     this->properties.at("m_per_tick")->number_value +
-                                 this->properties.at("tick_offset")->number_value;
+                                     (this->property(PropertyId::reversed)->boolean_value ? -1 : 1) /
+                                     this->property(PropertyId::m_per_tick)->number_value +
+                                 this->property(PropertyId::tick_offset)->number_value;
     std::memcpy(pos_data, &motor_position, 4);
-    this->can->send(this->can_id + 0x00c, pos_data); // "Set Input Pos"
+    this->can->send(this->can_id + 0x00c, pos_data, false, 8, can_tx_setpoint, this->can_id); // "Set Input Pos"
 }
 
 void ODriveMotor::limits(const float speed, const float current) {
     uint8_t limit_data[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-    const float motor_speed = speed / this->properties.at("m_per_tick")->number_value;
+    const float motor_speed = speed / this->property(PropertyId::m_per_tick)->number_value;
     std::memcpy(limit_data, &motor_speed, 4);
     std::memcpy(limit_data + 4, &current, 4);
-    this->can->send(this->can_id + 0x00f, limit_data); // "Set Limits"
+    this->can->send(this->can_id + 0x00f, limit_data, false, 8, can_tx_config, this->can_id); // "Set Limits"
 }
 
 void ODriveMotor::off() {
@@ -150,24 +171,32 @@ void ODriveMotor::off() {
 
 void ODriveMotor::reset_motor_error() {
     uint8_t empty_data[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-    this->can->send(this->can_id + 0x018, empty_data); // "Clear Errors"
+    this->can->send(this->can_id + 0x018, empty_data, false, 8, can_tx_config, this->can_id); // "Clear Errors"
 }
 void ODriveMotor::stop() {
     this->speed(0);
 }
 
-double ODriveMotor::get_position() {
-    return this->properties.at("position")->number_value;
+number_t ODriveMotor::get_position() {
+    return this->property(PropertyId::position)->number_value;
+}
+
+double ODriveMotor::get_precise_position() const {
+    return this->precise_position;
+}
+
+int64_t ODriveMotor::get_position_timestamp() const {
+    return this->position_timestamp;
 }
 
-void ODriveMotor::position(const double position, const double speed, const double acceleration) {
+void ODriveMotor::position(const number_t position, const number_t speed, const number_t acceleration) {
     this->position(static_cast<float>(position));
 }
 
-double ODriveMotor::get_speed() {
-    return this->properties.at("speed")->number_value;
+number_t ODriveMotor::get_speed() {
+    return this->property(PropertyId::speed)->number_value;
 }
 
-void ODriveMotor::speed(const double speed, const double acceleration) {
+void ODriveMotor::speed(const number_t speed, const number_t acceleration) {
     this->speed(static_cast<float>(speed));
 }
@@ -10,6 +10,29 @@ using ODriveMotor_ptr = std::shared_ptr<ODriveMotor>;
 
 class ODriveMotor : public Module, public std::enable_shared_from_this<ODriveMotor>, virtual public Motor {
 private:
+    enum class MethodId : unsigned int {
+        zero = Module::method_count,
+        power,
+        speed,
+        position,
+        limits,
+        off,
+        reset_motor,
+        count,
+    };
+    static const std::vector<Method> methods;
+    enum class PropertyId : unsigned int {
+        position,
+        speed,
+        tick_offset,
+        m_per_tick,
+        reversed,
+        axis_state,
+        axis_error,
+        motor_error_flag,
+        count,
+    };
+    static const std::vector<Property> property_table;
     const uint32_t can_id;
     const Can_ptr can;
     const uint32_t version;
@@ -17,13 +40,17 @@ private:
     uint8_t axis_state = -1;
     uint8_t axis_control_mode = -1;
     uint8_t axis_input_mode = -1;
+    double precise_position = 0;
+    int64_t position_timestamp = 0;
 
     void set_mode(const uint8_t state, const uint8_t control_mode = 0, const uint8_t input_mode = 0);
 
 public:
     ODriveMotor(const std::string name, const Can_ptr can, const uint32_t can_id, const uint32_t version);
     void subscribe_to_can();
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Property> &get_property_table() const override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
     void handle_can_msg(const uint32_t id, const int count, const uint8_t *const data) override;
     void power(const float torque);
     void speed(const float speed);
@@ -33,8 +60,10 @@ public:
     void reset_motor_error();
 
     void stop() override;
-    double get_position() override;
-    void position(const double position, const double speed, const double acceleration) override;
-    double get_speed() override;
-    void speed(const double speed, const double acceleration) override;
+    number_t get_position() override;
+    double get_precise_position() const;
+    int64_t get_position_timestamp() const;
+    void position(const number_t position, const number_t speed, const number_t acceleration) override;
+    number_t get_speed() override;
+    void speed(const number_t speed, const number_t acceleration) override;
 };
\ No newline at end of file
@@ -1,56 +1,83 @@
 #include "odrive_wheels.h"
-#include "../utils/timing.h"
+#include "esp_timer.h"
 #include <memory>
 
+const std::vector<Property> ODriveWheels::property_table = create_property_table<PropertyId::count>({
+    {"width", number},
+    {"linear_speed", number},
+    {"angular_speed", number},
+    {"enabled", boolean},
+});
+
+const std::vector<Property> &ODriveWheels::get_property_table() const {
+    return ODriveWheels::property_table;
+}
+
 ODriveWheels::ODriveWheels(const std::string name, const ODriveMotor_ptr left_motor, const ODriveMotor_ptr right_motor)
     : Module(odrive_wheels, name), left_motor(left_motor), right_motor(right_motor) {
-    this->properties["width"] = std::make_shared<NumberVariable>(1);
-    this->properties["linear_speed"] = std::make_shared<NumberVariable>();
-    this->properties["angular_speed"] = std::make_shared<NumberVariable>();
-    this->properties["enabled"] = std::make_shared<BooleanVariable>(true);
+    this->create_properties();
+    this->property(PropertyId::width)->set_number(1);
+    this->property(PropertyId::enabled)->set_boolean(true);
 }
 
-void ODriveWheels::step() {
-    double left_position = this->left_motor->get_position();
-    double right_position = this->right_motor->get_position();
-
-    if (this->initialized) {
-        unsigned long int d_micros = micros_since(this->last_micros);
-        double left_speed = (left_position - this->last_left_position) / d_micros * 1000000;
-        double right_speed = (right_position - this->last_right_position) / d_micros * 1000000;
-        this->properties.at("linear_speed")->number_value = (left_speed + right_speed) / 2;
-        this->properties.at("angular_speed")->number_value = (right_speed - left_speed) / this->properties.at("width")->number_value;
+void ODriveWheels::update_wheel(wheel_t &wheel, const double position, const int64_t timestamp, const int64_t now) {
+    if (timestamp != wheel.timestamp) {
+        const int64_t interval = timestamp - wheel.timestamp;
+        const bool is_continuous = wheel.timestamp != 0 && (wheel.interval == 0 || interval <= 3 * wheel.interval);
+        wheel.interval = is_continuous ? interval : 0;
+        wheel.speed = is_continuous ? (position - wheel.position) / interval * 1000000 : 0;
+        wheel.position = position;
+        wheel.timestamp = timestamp;
+    }
+    if (wheel.interval <= 0 || now - wheel.timestamp > 3 * wheel.interval) {
+        wheel.speed = 0;
     }
+}
 
-    this->last_micros = micros();
-    this->last_left_position = left_position;
-    this->last_right_position = right_position;
-    this->initialized = true;
+void ODriveWheels::step() {
+    const int64_t now = esp_timer_get_time();
+    ODriveWheels::update_wheel(this->left_wheel, this->left_motor->get_precise_position(), this->left_motor->get_position_timestamp(), now);
+    ODriveWheels::update_wheel(this->right_wheel, this->right_motor->get_precise_position(), this->right_motor->get_position_timestamp(), now);
+    const double left_speed = this->left_wheel.speed;
+    const double right_speed = this->right_wheel.speed;
+    this->property(PropertyId::linear_speed)->set_number((left_speed + right_speed) / 2);
+    this->property(PropertyId::angular_speed)->set_number((right_speed - left_speed) / this->property(PropertyId::width)->number_value);
 
     Module::step();
 }
 
-void ODriveWheels::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (method_name == "power") {
-        Module::expect(arguments, 2, numbery, numbery);
-        if (this->properties.at("enabled")->boolean_value) {
+const std::vector<Method> ODriveWheels::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"power", {numbery, numbery}},
+    {"speed", {numbery, numbery}},
+    {"off"},
+});
+
+const std::vector<Method> &ODriveWheels::get_methods() const {
+    return ODriveWheels::methods;
+}
+
+void ODriveWheels::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::power:
+        if (this->property(PropertyId::enabled)->boolean_value) {
             this->left_motor->power(arguments[0]->evaluate_number());
             this->right_motor->power(arguments[1]->evaluate_number());
         }
-    } else if (method_name == "speed") {
-        Module::expect(arguments, 2, numbery, numbery);
-        if (this->properties.at("enabled")->boolean_value) {
-            double linear = arguments[0]->evaluate_number();
-            double angular = arguments[1]->evaluate_number();
-            double width = this->properties.at("width")->number_value;
-            this->left_motor->speed(linear - angular * width / 2.0);
-            this->right_motor->speed(linear + angular * width / 2.0);
+        break;
+    case MethodId::speed:
+        if (this->property(PropertyId::enabled)->boolean_value) {
+            number_t linear = arguments[0]->evaluate_number();
+            number_t angular = arguments[1]->evaluate_number();
+            number_t width = this->property(PropertyId::width)->number_value;
+            this->left_motor->speed(linear - angular * width / 2);
+            this->right_motor->speed(linear + angular * width / 2);
         }
-    } else if (method_name == "off") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::off:
         this->left_motor->off();
         this->right_motor->off();
-    } else {
-        Module::call(method_name, arguments);
+        break;
+    default:
+        Module::call(method_id, arguments);
     }
 }
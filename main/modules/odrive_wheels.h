@@ -5,16 +5,40 @@
 
 class ODriveWheels : public Module {
 private:
+    enum class MethodId : unsigned int {
+        power = Module::method_count,
+        speed,
+        off,
+        count,
+    };
+    static const std::vector<Method> methods;
+    enum class PropertyId : unsigned int {
+        width,
+        linear_speed,
+        angular_speed,
+        enabled,
+        count,
+    };
+    static const std::vector<Property> property_table;
     const ODriveMotor_ptr left_motor;
     const ODriveMotor_ptr right_motor;
 
-    bool initialized = false;
-    unsigned long int last_micros;
-    double last_left_position;
-    double last_right_position;
+    // positions and speeds are kept in double, because single precision is too coarse for long distances
+    struct wheel_t {
+        double position = 0;
+        int64_t timestamp = 0;
+        int64_t interval = 0;
+        double speed = 0;
+    };
+    wheel_t left_wheel;
+    wheel_t right_wheel;
+
+    static void update_wheel(wheel_t &wheel, const double position, const int64_t timestamp, const int64_t now);
 
 public:
     ODriveWheels(const std::string name, const ODriveMotor_ptr left_motor, const ODriveMotor_ptr right_motor);
     void step() override;
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Property> &get_property_table() const override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
 };
\ No newline at end of file
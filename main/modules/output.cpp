@@ -2,9 +2,17 @@
 #include "utils/timing.h"
 #include <math.h>
 
+const std::vector<Property> Output::property_table = create_property_table<PropertyId::count>({
+    {"level", integer},
+    {"change", integer},
+});
+
+const std::vector<Property> &Output::get_property_table() const {
+    return Output::property_table;
+}
+
 Output::Output(const std::string name) : Module(output, name) {
-    this->properties["level"] = std::make_shared<IntegerVariable>();
-    this->properties["change"] = std::make_shared<IntegerVariable>();
+    this->create_properties();
 }
 
 void Output::step() {
@@ -13,35 +21,44 @@ void Output::step() {
     }
 
     this->set_level(this->target_level);
-    this->properties.at("change")->integer_value = this->target_level - this->properties.at("level")->integer_value;
-    this->properties.at("level")->integer_value = this->target_level;
+    this->property(PropertyId::change)->set_integer(this->target_level - this->property(PropertyId::level)->integer_value);
+    this->property(PropertyId::level)->set_integer(this->target_level);
+}
+
+const std::vector<Method> Output::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"on"},
+    {"off"},
+    {"level", {boolean}},
+    {"pulse", 1, 2, {numbery, numbery}},
+});
+
+const std::vector<Method> &Output::get_methods() const {
+    return Output::methods;
 }
 
-void Output::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (method_name == "on") {
-        Module::expect(arguments, 0);
+void Output::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::on:
         this->target_level = 1;
         this->pulse_interval = 0;
         this->step();
-    } else if (method_name == "off") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::off:
         this->target_level = 0;
         this->pulse_interval = 0;
         this->step();
-    } else if (method_name == "level") {
-        Module::expect(arguments, 1, boolean);
+        break;
+    case MethodId::level:
         this->target_level = arguments[0]->evaluate_boolean();
         this->pulse_interval = 0;
         this->step();
-    } else if (method_name == "pulse") {
-        if (arguments.size() < 1 || arguments.size() > 2) {
-            throw std::runtime_error("unexpected number of arguments");
-        }
-        Module::expect(arguments, -1, numbery, numbery);
+        break;
+    case MethodId::pulse:
         this->pulse_interval = arguments[0]->evaluate_number();
         this->pulse_duty_cycle = arguments.size() > 1 ? arguments[1]->evaluate_number() : 0.5;
-    } else {
-        Module::call(method_name, arguments);
+        break;
+    default:
+        Module::call(method_id, arguments);
     }
 }
 
@@ -6,17 +6,33 @@
 
 class Output : public Module {
 private:
+    enum class MethodId : unsigned int {
+        on = Module::method_count,
+        off,
+        level,
+        pulse,
+        count,
+    };
+    static const std::vector<Method> methods;
+    static const std::vector<Property> property_table;
     int target_level = 0;
     double pulse_interval = 0.0;
     double pulse_duty_cycle = 0.5;
     virtual void set_level(bool level) const = 0;
 
 protected:
+    enum class PropertyId : unsigned int {
+        level,
+        change,
+        count,
+    };
     Output(const std::string name);
 
 public:
     void step() override;
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Property> &get_property_table() const override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
 };
 
 class GpioOutput : public Output {
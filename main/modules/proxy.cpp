@@ -1,4 +1,5 @@
 #include "proxy.h"
+#include "../global.h"
 #include "driver/uart.h"
 #include <memory>
 
@@ -18,24 +19,40 @@ Proxy::Proxy(const std::string name,
     // before the first expander broadcast, making them unusable for rule
     // definitions.
     if (module_type == "Input") {
-        this->properties["level"] = std::make_shared<IntegerVariable>(0);
-        this->properties["active"] = std::make_shared<BooleanVariable>(false);
+        this->property_table.push_back({"level", integer});
+        this->property_table.push_back({"active", boolean});
+        this->create_properties();
     }
 
     expander->serial->write_checked_line(buffer, pos);
 }
 
-void Proxy::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
+unsigned int Proxy::find_method(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) const {
+    return Module::intern_method_name(method_name);
+}
+
+void Proxy::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
     static char buffer[256];
+    const std::string &method_name = Module::interned_method_names.at(method_id);
     int pos = std::sprintf(buffer, "%s.%s(", this->name.c_str(), method_name.c_str());
     pos += write_arguments_to_buffer(arguments, &buffer[pos]);
     pos += std::sprintf(&buffer[pos], ")");
     this->expander->serial->write_checked_line(buffer, pos);
 }
 
+const std::vector<Property> &Proxy::get_property_table() const {
+    return this->property_table;
+}
+
 void Proxy::write_property(const std::string property_name, const ConstExpression_ptr expression, const bool from_expander) {
-    if (!this->properties.count(property_name)) {
-        this->properties[property_name] = std::make_shared<Variable>(expression->type);
+    bool has_property = false;
+    for (auto const &property : this->property_table) {
+        has_property = has_property || property.name == property_name;
+    }
+    if (!has_property) {
+        this->property_table.push_back({property_name, expression->type});
+        this->properties.push_back(std::make_shared<Variable>(expression->type));
+        Global::generation++;
     }
     if (!from_expander) {
         static char buffer[256];
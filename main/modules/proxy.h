@@ -6,6 +6,7 @@
 class Proxy : public Module {
 private:
     const Expander_ptr expander;
+    std::vector<Property> property_table;
 
 public:
     Proxy(const std::string name,
@@ -13,6 +14,8 @@ public:
           const std::string module_type,
           const Expander_ptr expander,
           const std::vector<ConstExpression_ptr> arguments);
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    unsigned int find_method(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Property> &get_property_table() const override;
     void write_property(const std::string property_name, const ConstExpression_ptr expression, const bool from_expander) override;
 };
\ No newline at end of file
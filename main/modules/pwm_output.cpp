@@ -1,6 +1,15 @@
 #include "pwm_output.h"
 #include <driver/ledc.h>
 
+const std::vector<Property> PwmOutput::property_table = create_property_table<PropertyId::count>({
+    {"frequency", integer},
+    {"duty", integer},
+});
+
+const std::vector<Property> &PwmOutput::get_property_table() const {
+    return PwmOutput::property_table;
+}
+
 PwmOutput::PwmOutput(const std::string name,
                      const gpio_num_t pin,
                      const ledc_timer_t ledc_timer,
@@ -8,14 +17,15 @@ PwmOutput::PwmOutput(const std::string name,
     : Module(pwm_output, name), pin(pin), ledc_timer(ledc_timer), ledc_channel(ledc_channel) {
     gpio_reset_pin(pin);
 
-    this->properties["frequency"] = std::make_shared<IntegerVariable>(1000);
-    this->properties["duty"] = std::make_shared<IntegerVariable>(128);
+    this->create_properties();
+    this->property(PropertyId::frequency)->set_integer(1000);
+    this->property(PropertyId::duty)->set_integer(128);
 
     ledc_timer_config_t timer_config = {
         .speed_mode = LEDC_HIGH_SPEED_MODE,
         .duty_resolution = LEDC_TIMER_8_BIT,
         .timer_num = ledc_timer,
-        .freq_hz = (uint32_t)this->properties.at("frequency")->integer_value,
+        .freq_hz = (uint32_t)this->property(PropertyId::frequency)->integer_value,
         .clk_cfg = LEDC_AUTO_CLK,
     };
     ledc_channel_config_t channel_config = {
@@ -34,22 +44,32 @@ PwmOutput::PwmOutput(const std::string name,
 }
 
 void PwmOutput::step() {
-    uint32_t frequency = this->properties.at("frequency")->integer_value;
+    uint32_t frequency = this->property(PropertyId::frequency)->integer_value;
     ledc_set_freq(LEDC_HIGH_SPEED_MODE, this->ledc_timer, frequency);
-    uint32_t duty = this->properties.at("duty")->integer_value;
+    uint32_t duty = this->property(PropertyId::duty)->integer_value;
     ledc_set_duty(LEDC_HIGH_SPEED_MODE, this->ledc_channel, this->is_on ? duty : 0);
     ledc_update_duty(LEDC_HIGH_SPEED_MODE, this->ledc_channel);
     Module::step();
 }
 
-void PwmOutput::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (method_name == "on") {
-        Module::expect(arguments, 0);
+const std::vector<Method> PwmOutput::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"on"},
+    {"off"},
+});
+
+const std::vector<Method> &PwmOutput::get_methods() const {
+    return PwmOutput::methods;
+}
+
+void PwmOutput::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::on:
         this->is_on = true;
-    } else if (method_name == "off") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::off:
         this->is_on = false;
-    } else {
-        Module::call(method_name, arguments);
+        break;
+    default:
+        Module::call(method_id, arguments);
     }
 }
@@ -6,6 +6,18 @@
 
 class PwmOutput : public Module {
 private:
+    enum class MethodId : unsigned int {
+        on = Module::method_count,
+        off,
+        count,
+    };
+    static const std::vector<Method> methods;
+    enum class PropertyId : unsigned int {
+        frequency,
+        duty,
+        count,
+    };
+    static const std::vector<Property> property_table;
     const gpio_num_t pin;
     const ledc_timer_t ledc_timer;
     const ledc_channel_t ledc_channel;
@@ -17,5 +29,7 @@ public:
               const ledc_timer_t ledc_timer,
               const ledc_channel_t ledc_channel);
     void step() override;
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Property> &get_property_table() const override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
 };
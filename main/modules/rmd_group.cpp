@@ -0,0 +1,78 @@
+#include "rmd_group.h"
+#include <algorithm>
+
+RmdGroup::RmdGroup(const std::string name, const std::vector<RmdMotor_ptr> motors)
+    : Module(rmd_group, name), motors(motors) {
+}
+
+void RmdGroup::step() {
+    const bool is_bus_covered = RmdMotor::covers_bus(this->motors);
+    for (auto const &motor : this->motors) {
+        motor->set_polled_by_group(is_bus_covered);
+    }
+    if (is_bus_covered && std::none_of(this->motors.begin(), this->motors.end(), [](const RmdMotor_ptr &motor) { return motor->is_requested(0x9c); })) {
+        RmdMotor::send_to_all(this->motors, {{0x9c, 0, 0, 0, 0, 0, 0, 0}});
+    }
+    Module::step();
+}
+
+std::vector<rmd_payload_t> RmdGroup::get_payloads(const std::vector<ConstExpression_ptr> arguments,
+                                                  rmd_payload_t (*request)(const double value)) const {
+    if (arguments.size() != 1 && arguments.size() != this->motors.size()) {
+        throw std::runtime_error("expecting 1 or " + std::to_string(this->motors.size()) + " arguments, got " + std::to_string(arguments.size()));
+    }
+    std::vector<rmd_payload_t> payloads;
+    for (auto const &argument : arguments) {
+        payloads.push_back(request(argument->evaluate_number()));
+    }
+    return payloads;
+}
+
+const std::vector<Method> RmdGroup::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"power", 1, 8, {numbery, numbery, numbery, numbery, numbery, numbery, numbery, numbery}},
+    {"speed", 1, 8, {numbery, numbery, numbery, numbery, numbery, numbery, numbery, numbery}},
+    {"position", 1, 8, {numbery, numbery, numbery, numbery, numbery, numbery, numbery, numbery}},
+    {"stop"},
+    {"off"},
+    {"hold"},
+    {"clear_errors"},
+});
+
+const std::vector<Method> &RmdGroup::get_methods() const {
+    return RmdGroup::methods;
+}
+
+void RmdGroup::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::power:
+        RmdMotor::send_to_all(this->motors, this->get_payloads(arguments, RmdMotor::power_request));
+        break;
+    case MethodId::speed:
+        RmdMotor::send_to_all(this->motors, this->get_payloads(arguments, RmdMotor::speed_request));
+        break;
+    case MethodId::position:
+        RmdMotor::send_to_all(this->motors, this->get_payloads(arguments, [](const double position) {
+                                  return RmdMotor::position_request(position);
+                              }));
+        break;
+    case MethodId::stop:
+        RmdMotor::send_to_all(this->motors, {{0x81, 0, 0, 0, 0, 0, 0, 0}}, true);
+        break;
+    case MethodId::off:
+        RmdMotor::send_to_all(this->motors, {{0x80, 0, 0, 0, 0, 0, 0, 0}}, true);
+        break;
+    case MethodId::hold: {
+        std::vector<rmd_payload_t> payloads;
+        for (auto const &motor : this->motors) {
+            payloads.push_back(RmdMotor::position_request(motor->get_position()));
+        }
+        RmdMotor::send_to_all(this->motors, payloads);
+        break;
+    }
+    case MethodId::clear_errors:
+        RmdMotor::send_to_all(this->motors, {{0x76, 0, 0, 0, 0, 0, 0, 0}});
+        break;
+    default:
+        Module::call(method_id, arguments);
+    }
+}
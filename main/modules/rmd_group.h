@@ -0,0 +1,33 @@
+#pragma once
+
+#include "module.h"
+#include "rmd_motor.h"
+#include <memory>
+
+class RmdGroup;
+using RmdGroup_ptr = std::shared_ptr<RmdGroup>;
+
+class RmdGroup : public Module {
+private:
+    enum class MethodId : unsigned int {
+        power = Module::method_count,
+        speed,
+        position,
+        stop,
+        off,
+        hold,
+        clear_errors,
+        count,
+    };
+    static const std::vector<Method> methods;
+    const std::vector<RmdMotor_ptr> motors;
+
+    std::vector<rmd_payload_t> get_payloads(const std::vector<ConstExpression_ptr> arguments,
+                                            rmd_payload_t (*request)(const double value)) const;
+
+public:
+    RmdGroup(const std::string name, const std::vector<RmdMotor_ptr> motors);
+    void step() override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
+};
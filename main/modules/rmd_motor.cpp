@@ -2,17 +2,29 @@
 #include "../global.h"
 #include "../utils/timing.h"
 #include "../utils/uart.h"
+#include <algorithm>
 #include <cstring>
 #include <math.h>
 #include <memory>
 
+#define RMD_MAX_ATTEMPTS 3
+#define RMD_MAX_QUEUED_REQUESTS 16
+
+const std::vector<Property> RmdMotor::property_table = create_property_table<PropertyId::count>({
+    {"position", number},
+    {"torque", number},
+    {"speed", number},
+    {"temperature", number},
+    {"can_age", number},
+});
+
+const std::vector<Property> &RmdMotor::get_property_table() const {
+    return RmdMotor::property_table;
+}
+
 RmdMotor::RmdMotor(const std::string name, const Can_ptr can, const uint8_t motor_id, const int ratio)
     : Module(rmd_motor, name), motor_id(motor_id), can(can), ratio(ratio), encoder_range(262144.0 / ratio) {
-    this->properties["position"] = std::make_shared<NumberVariable>();
-    this->properties["torque"] = std::make_shared<NumberVariable>();
-    this->properties["speed"] = std::make_shared<NumberVariable>();
-    this->properties["temperature"] = std::make_shared<NumberVariable>();
-    this->properties["can_age"] = std::make_shared<NumberVariable>();
+    this->create_properties();
 }
 
 void RmdMotor::subscribe_to_can() {
@@ -21,113 +33,245 @@ void RmdMotor::subscribe_to_can() {
 
 bool RmdMotor::send(const uint8_t d0, const uint8_t d1, const uint8_t d2, const uint8_t d3,
                     const uint8_t d4, const uint8_t d5, const uint8_t d6, const uint8_t d7,
-                    const unsigned long int timeout_ms) {
-    this->last_msg_id = 0;
-    const int max_attempts = 3;
-    for (int i = 0; i < max_attempts; ++i) {
-        this->can->send(this->motor_id + 0x140, d0, d1, d2, d3, d4, d5, d6, d7);
-        unsigned long int start = micros();
-        while (this->last_msg_id != d0 && micros_since(start) < timeout_ms * 1000) {
-            this->can->receive();
+                    const unsigned long int timeout_ms, const bool is_urgent, const bool is_blocking) {
+    return this->send({d0, d1, d2, d3, d4, d5, d6, d7}, timeout_ms, is_urgent, is_blocking);
+}
+
+bool RmdMotor::send(const rmd_payload_t &data, const unsigned long int timeout_ms, const bool is_urgent,
+                    const bool is_blocking) {
+    const uint8_t d0 = data[0];
+    request_t request = {data, timeout_ms, is_urgent ? can_tx_emergency : can_tx_config, 0, 1, is_blocking};
+    if (is_urgent) {
+        this->cancel_requests(d0);
+        this->transmit(request);
+        this->pending_requests.push_back(request);
+        return true;
+    }
+    if (d0 >= 0xa1 && d0 <= 0xa8) {
+        for (auto &queued : this->queued_requests) {
+            if (queued.data[0] == d0) {
+                queued = request;
+                return true;
+            }
         }
-        if (this->last_msg_id == d0) {
+    }
+    if (this->queued_requests.size() >= RMD_MAX_QUEUED_REQUESTS) {
+        echo("%s warning: too many queued requests, dropping msg id 0x%02x", this->name.c_str(), d0);
+        return false;
+    }
+    this->queued_requests.push_back(request);
+    this->process_requests();
+    return true;
+}
+
+void RmdMotor::expect_reply(const rmd_payload_t &data, const bool is_urgent) {
+    if (is_urgent) {
+        this->cancel_requests(data[0]);
+    }
+    this->pending_requests.push_back({data, 3, is_urgent ? can_tx_emergency : can_tx_config, micros(), 1, false});
+}
+
+void RmdMotor::cancel_requests(const uint8_t urgent_command) {
+    // after a stop or off no earlier setpoint may be repeated, because it would move the motor again
+    this->queued_requests.clear();
+    this->can->discard_tx(this->motor_id + 0x140);
+    this->can->discard_tx(0x280);
+    this->pending_requests.erase(std::remove_if(this->pending_requests.begin(), this->pending_requests.end(),
+                                                [urgent_command](const request_t &pending) {
+                                                    const uint8_t command = pending.data[0];
+                                                    return command == urgent_command ||
+                                                           (command >= 0xa1 && command <= 0xa8) ||
+                                                           command == 0x43;
+                                                }),
+                                 this->pending_requests.end());
+}
+
+bool RmdMotor::is_pending(const uint8_t command) const {
+    for (auto const &request : this->pending_requests) {
+        if (request.data[0] == command) {
             return true;
-        } else {
-            echo("%s warning: CAN timeout for msg id 0x%02x (attempt %d/%d)", this->name.c_str(), d0, i + 1, max_attempts);
         }
     }
     return false;
 }
 
+bool RmdMotor::is_blocked() const {
+    return std::any_of(this->pending_requests.begin(), this->pending_requests.end(),
+                       [](const request_t &pending) { return pending.is_blocking; });
+}
+
+bool RmdMotor::is_requested(const uint8_t command) const {
+    if (this->is_pending(command)) {
+        return true;
+    }
+    for (auto const &request : this->queued_requests) {
+        if (request.data[0] == command) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RmdMotor::transmit(request_t &request) {
+    this->can->send(this->motor_id + 0x140, request.data.data(), false, 8, request.priority);
+    request.sent_micros = micros();
+}
+
+void RmdMotor::check_timeouts() {
+    for (auto it = this->pending_requests.begin(); it != this->pending_requests.end();) {
+        if (micros_since(it->sent_micros) < it->timeout_ms * 1000) {
+            ++it;
+            continue;
+        }
+        echo("%s warning: CAN timeout for msg id 0x%02x (attempt %d/%d)",
+             this->name.c_str(), it->data[0], it->attempts, RMD_MAX_ATTEMPTS);
+        if (it->attempts < RMD_MAX_ATTEMPTS) {
+            it->attempts++;
+            this->transmit(*it);
+            ++it;
+            continue;
+        }
+        if (it->is_blocking) {
+            echo("%s error: no reply to msg id 0x%02x, discarding %d queued requests",
+                 this->name.c_str(), it->data[0], (int)this->queued_requests.size());
+            this->queued_requests.clear();
+            this->aborted_count++;
+        }
+        it = this->pending_requests.erase(it);
+    }
+}
+
+void RmdMotor::process_requests() {
+    while (!this->queued_requests.empty() && !this->is_blocked() && !this->is_pending(this->queued_requests.front().data[0])) {
+        request_t request = this->queued_requests.front();
+        this->queued_requests.pop_front();
+        this->transmit(request);
+        this->pending_requests.push_back(request);
+    }
+}
+
 void RmdMotor::step() {
-    this->properties.at("can_age")->number_value = millis_since(this->last_msg_millis) / 1e3;
+    this->property(PropertyId::can_age)->set_number(millis_since(this->last_msg_millis) / 1e3);
+
+    while (this->can->receive()) {
+    }
+    this->check_timeouts();
+    this->process_requests();
 
-    if (!this->has_last_encoder_position) {
+    if (!this->has_last_encoder_position && !this->is_requested(0x92)) {
         this->send(0x92, 0, 0, 0, 0, 0, 0, 0);
     }
-    this->send(0x9c, 0, 0, 0, 0, 0, 0, 0);
+    if (!this->is_polled_by_group && !this->is_requested(0x9c)) {
+        this->send(0x9c, 0, 0, 0, 0, 0, 0, 0);
+    }
     Module::step();
 }
 
-bool RmdMotor::power(double target_power) {
+rmd_payload_t RmdMotor::power_request(const double target_power) {
     int16_t power = target_power * 100;
-    return this->send(0xa1, 0,
-                      0,
-                      0,
-                      *((uint8_t *)(&power) + 0),
-                      *((uint8_t *)(&power) + 1),
-                      0,
-                      0);
+    return {0xa1, 0,
+            0,
+            0,
+            *((uint8_t *)(&power) + 0),
+            *((uint8_t *)(&power) + 1),
+            0,
+            0};
 }
 
-bool RmdMotor::speed(double target_speed) {
+rmd_payload_t RmdMotor::speed_request(const double target_speed) {
     int32_t speed = target_speed * 100;
-    return this->send(0xa2, 0,
-                      0,
-                      0,
-                      *((uint8_t *)(&speed) + 0),
-                      *((uint8_t *)(&speed) + 1),
-                      *((uint8_t *)(&speed) + 2),
-                      *((uint8_t *)(&speed) + 3));
+    return {0xa2, 0,
+            0,
+            0,
+            *((uint8_t *)(&speed) + 0),
+            *((uint8_t *)(&speed) + 1),
+            *((uint8_t *)(&speed) + 2),
+            *((uint8_t *)(&speed) + 3)};
 }
 
-bool RmdMotor::position(double target_position, double target_speed) {
+rmd_payload_t RmdMotor::position_request(const double target_position, const double target_speed) {
     int32_t position = target_position * 100;
     uint16_t speed = target_speed;
-    return this->send(0xa4, 0,
-                      *((uint8_t *)(&speed) + 0),
-                      *((uint8_t *)(&speed) + 1),
-                      *((uint8_t *)(&position) + 0),
-                      *((uint8_t *)(&position) + 1),
-                      *((uint8_t *)(&position) + 2),
-                      *((uint8_t *)(&position) + 3));
+    return {0xa4, 0,
+            *((uint8_t *)(&speed) + 0),
+            *((uint8_t *)(&speed) + 1),
+            *((uint8_t *)(&position) + 0),
+            *((uint8_t *)(&position) + 1),
+            *((uint8_t *)(&position) + 2),
+            *((uint8_t *)(&position) + 3)};
+}
+
+bool RmdMotor::power(double target_power) {
+    return this->send(RmdMotor::power_request(target_power));
+}
+
+bool RmdMotor::speed(double target_speed) {
+    return this->send(RmdMotor::speed_request(target_speed));
+}
+
+bool RmdMotor::position(double target_position, double target_speed) {
+    return this->send(RmdMotor::position_request(target_position, target_speed));
 }
 
 bool RmdMotor::stop() {
-    return this->send(0x81, 0, 0, 0, 0, 0, 0, 0);
+    return this->send(0x81, 0, 0, 0, 0, 0, 0, 0, 3, true);
 }
 
 bool RmdMotor::off() {
-    return this->send(0x80, 0, 0, 0, 0, 0, 0, 0);
+    return this->send(0x80, 0, 0, 0, 0, 0, 0, 0, 3, true);
 }
 
 bool RmdMotor::hold() {
-    return this->position(this->properties.at("position")->number_value);
+    return this->position(this->property(PropertyId::position)->number_value);
 }
 
 bool RmdMotor::clear_errors() {
     return this->send(0x76, 0, 0, 0, 0, 0, 0, 0);
 }
 
-void RmdMotor::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (method_name == "power") {
-        Module::expect(arguments, 1, numbery);
+const std::vector<Method> RmdMotor::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"power", {numbery}},
+    {"speed", {numbery}},
+    {"position", 1, 2, {numbery, numbery}},
+    {"stop"},
+    {"off"},
+    {"hold"},
+    {"get_pid"},
+    {"set_pid", {integer, integer, integer, integer, integer, integer}},
+    {"get_acceleration"},
+    {"set_acceleration", {integer, integer, integer, integer}},
+    {"get_status"},
+    {"clear_errors"},
+});
+
+const std::vector<Method> &RmdMotor::get_methods() const {
+    return RmdMotor::methods;
+}
+
+void RmdMotor::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::power:
         this->power(arguments[0]->evaluate_number());
-    } else if (method_name == "speed") {
-        Module::expect(arguments, 1, numbery);
+        break;
+    case MethodId::speed:
         this->speed(arguments[0]->evaluate_number());
-    } else if (method_name == "position") {
-        if (arguments.size() == 1) {
-            Module::expect(arguments, 1, numbery);
-            this->position(arguments[0]->evaluate_number(), 0);
-        } else {
-            Module::expect(arguments, 2, numbery, numbery);
-            this->position(arguments[0]->evaluate_number(), arguments[1]->evaluate_number());
-        }
-    } else if (method_name == "stop") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::position:
+        this->position(arguments[0]->evaluate_number(), arguments.size() > 1 ? arguments[1]->evaluate_number() : 0);
+        break;
+    case MethodId::stop:
         this->stop();
-    } else if (method_name == "off") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::off:
         this->off();
-    } else if (method_name == "hold") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::hold:
         this->hold();
-    } else if (method_name == "get_pid") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::get_pid:
         this->send(0x30, 0, 0, 0, 0, 0, 0, 0);
-    } else if (method_name == "set_pid") {
-        Module::expect(arguments, 6, integer, integer, integer, integer, integer, integer);
+        break;
+    case MethodId::set_pid:
         this->send(0x32, 0,
                    arguments[4]->evaluate_integer(),
                    arguments[5]->evaluate_integer(),
@@ -135,25 +279,26 @@ void RmdMotor::call(const std::string method_name, const std::vector<ConstExpres
                    arguments[3]->evaluate_integer(),
                    arguments[0]->evaluate_integer(),
                    arguments[1]->evaluate_integer());
-    } else if (method_name == "get_acceleration") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::get_acceleration:
         this->send(0x42, 0, 0, 0, 0, 0, 0, 0);
-    } else if (method_name == "set_acceleration") {
-        Module::expect(arguments, 4, integer, integer, integer, integer);
+        break;
+    case MethodId::set_acceleration:
         for (uint8_t i = 0; i < 4; ++i) {
             int acceleration = arguments[i]->evaluate_integer();
             if (acceleration > 0) {
                 set_acceleration(i, acceleration);
             }
         }
-    } else if (method_name == "get_status") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::get_status:
         this->send(0x9a, 0, 0, 0, 0, 0, 0, 0);
-    } else if (method_name == "clear_errors") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::clear_errors:
         this->clear_errors();
-    } else {
-        Module::call(method_name, arguments);
+        break;
+    default:
+        Module::call(method_id, arguments);
     }
 }
 
@@ -173,7 +318,7 @@ void RmdMotor::handle_can_msg(const uint32_t id, const int count, const uint8_t
     case 0x60: {
         int32_t encoder = 0;
         std::memcpy(&encoder, data + 4, 4);
-        this->properties.at("position")->number_value = encoder / 16384.0 * 360.0 / this->ratio; // 16384 = 2^14
+        this->property(PropertyId::position)->set_number(encoder / 16384.0 * 360.0 / this->ratio); // 16384 = 2^14
         break;
     }
     case 0x30: {
@@ -214,7 +359,7 @@ void RmdMotor::handle_can_msg(const uint32_t id, const int count, const uint8_t
     case 0x92: {
         int32_t position = 0;
         std::memcpy(&position, data + 4, 4);
-        this->properties.at("position")->number_value = 0.01 * position;
+        this->property(PropertyId::position)->set_number(0.01 * position);
         this->last_encoder_position = modulo_encoder_range(0.01 * position, this->encoder_range);
         this->has_last_encoder_position = true;
         break;
@@ -222,42 +367,48 @@ void RmdMotor::handle_can_msg(const uint32_t id, const int count, const uint8_t
     case 0x9c: {
         int8_t temperature = 0;
         std::memcpy(&temperature, data + 1, 1);
-        this->properties.at("temperature")->number_value = temperature;
+        this->property(PropertyId::temperature)->set_number(temperature);
 
         int16_t torque = 0;
         std::memcpy(&torque, data + 2, 2);
-        this->properties.at("torque")->number_value = 0.01 * torque;
+        this->property(PropertyId::torque)->set_number(0.01 * torque);
 
         int16_t speed = 0;
         std::memcpy(&speed, data + 4, 2);
-        this->properties.at("speed")->number_value = speed;
+        this->property(PropertyId::speed)->set_number(speed);
 
         int16_t position = 0;
         std::memcpy(&position, data + 6, 2);
         int32_t encoder_position = position;
         if (this->has_last_encoder_position) {
-            this->properties.at("position")->number_value += encoder_position - this->last_encoder_position;
+            this->property(PropertyId::position)->set_number(this->property(PropertyId::position)->number_value + (encoder_position - this->last_encoder_position));
             if (encoder_position - this->last_encoder_position > this->encoder_range / 2) {
-                this->properties.at("position")->number_value -= this->encoder_range;
+                this->property(PropertyId::position)->set_number(this->property(PropertyId::position)->number_value - this->encoder_range);
             }
             if (encoder_position - this->last_encoder_position < -this->encoder_range / 2) {
-                this->properties.at("position")->number_value += this->encoder_range;
+                this->property(PropertyId::position)->set_number(this->property(PropertyId::position)->number_value + this->encoder_range);
             }
             this->last_encoder_position = encoder_position;
         }
         break;
     }
     }
-    this->last_msg_id = data[0];
     this->last_msg_millis = millis();
+    for (auto it = this->pending_requests.begin(); it != this->pending_requests.end(); ++it) {
+        if (it->data[0] == data[0]) {
+            this->pending_requests.erase(it);
+            this->process_requests();
+            break;
+        }
+    }
 }
 
-double RmdMotor::get_position() const {
-    return this->properties.at("position")->number_value;
+number_t RmdMotor::get_position() const {
+    return this->property(PropertyId::position)->number_value;
 }
 
-double RmdMotor::get_speed() const {
-    return this->properties.at("speed")->number_value;
+number_t RmdMotor::get_speed() const {
+    return this->property(PropertyId::speed)->number_value;
 }
 
 bool RmdMotor::set_acceleration(const uint8_t index, const uint32_t acceleration) {
@@ -269,5 +420,54 @@ bool RmdMotor::set_acceleration(const uint8_t index, const uint32_t acceleration
                       *((uint8_t *)(&acceleration) + 1),
                       *((uint8_t *)(&acceleration) + 2),
                       *((uint8_t *)(&acceleration) + 3),
-                      20);
+                      20, false, true);
+}
+
+unsigned int RmdMotor::get_aborted_count() const {
+    return this->aborted_count;
+}
+
+void RmdMotor::set_polled_by_group(const bool is_polled_by_group) {
+    this->is_polled_by_group = is_polled_by_group;
+}
+
+bool RmdMotor::covers_bus(const std::vector<RmdMotor_ptr> &motors) {
+    if (motors.empty()) {
+        return false;
+    }
+    for (auto const &motor : motors) {
+        if (motor->can != motors[0]->can) {
+            return false;
+        }
+    }
+    for (auto const &item : Global::modules) {
+        if (item.second->type != rmd_motor) {
+            continue;
+        }
+        const RmdMotor_ptr motor = std::static_pointer_cast<RmdMotor>(item.second);
+        if (motor->can == motors[0]->can && std::find(motors.begin(), motors.end(), motor) == motors.end()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RmdMotor::send_to_all(const std::vector<RmdMotor_ptr> &motors, const std::vector<rmd_payload_t> &payloads, const bool is_urgent) {
+    bool is_broadcast = std::all_of(payloads.begin(), payloads.end(), [&payloads](const rmd_payload_t &payload) { return payload == payloads[0]; }) &&
+                        RmdMotor::covers_bus(motors);
+    for (auto const &motor : motors) {
+        is_broadcast = is_broadcast && (is_urgent || (motor->queued_requests.empty() && !motor->is_blocked() && !motor->is_pending(payloads[0][0])));
+    }
+    if (is_broadcast) {
+        motors[0]->can->send(0x280, payloads[0].data(), false, 8, is_urgent ? can_tx_emergency : can_tx_config);
+        for (auto const &motor : motors) {
+            motor->expect_reply(payloads[0], is_urgent);
+        }
+        return true;
+    }
+    bool success = true;
+    for (size_t i = 0; i < motors.size(); ++i) {
+        success = motors[i]->send(payloads[payloads.size() == 1 ? 0 : i], 3, is_urgent) && success;
+    }
+    return success;
 }
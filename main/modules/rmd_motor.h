@@ -2,32 +2,83 @@
 
 #include "can.h"
 #include "module.h"
+#include <array>
+#include <deque>
 #include <memory>
 
 class RmdMotor;
 using RmdMotor_ptr = std::shared_ptr<RmdMotor>;
 using ConstRmdMotor_ptr = std::shared_ptr<const RmdMotor>;
+using rmd_payload_t = std::array<uint8_t, 8>;
 
 class RmdMotor : public Module, public std::enable_shared_from_this<RmdMotor> {
 private:
+    enum class MethodId : unsigned int {
+        power = Module::method_count,
+        speed,
+        position,
+        stop,
+        off,
+        hold,
+        get_pid,
+        set_pid,
+        get_acceleration,
+        set_acceleration,
+        get_status,
+        clear_errors,
+        count,
+    };
+    static const std::vector<Method> methods;
+    enum class PropertyId : unsigned int {
+        position,
+        torque,
+        speed,
+        temperature,
+        can_age,
+        count,
+    };
+    static const std::vector<Property> property_table;
     const uint32_t motor_id;
     const Can_ptr can;
-    uint8_t last_msg_id = 0;
     int ratio;
     const double encoder_range;
     int32_t last_encoder_position;
     bool has_last_encoder_position = false;
     unsigned long int last_msg_millis = 0;
+    bool is_polled_by_group = false;
+
+    struct request_t {
+        rmd_payload_t data;
+        unsigned long int timeout_ms;
+        CanTxPriority priority;
+        unsigned long int sent_micros;
+        int attempts;
+        bool is_blocking;
+    };
+    std::deque<request_t> queued_requests;
+    std::vector<request_t> pending_requests;
+    unsigned int aborted_count = 0;
 
     bool send(const uint8_t d0, const uint8_t d1, const uint8_t d2, const uint8_t d3,
               const uint8_t d4, const uint8_t d5, const uint8_t d6, const uint8_t d7,
-              const unsigned long int timeout_ms = 3);
+              const unsigned long int timeout_ms = 3, const bool is_urgent = false, const bool is_blocking = false);
+    bool send(const rmd_payload_t &data, const unsigned long int timeout_ms = 3, const bool is_urgent = false,
+              const bool is_blocking = false);
+    void expect_reply(const rmd_payload_t &data, const bool is_urgent);
+    void cancel_requests(const uint8_t urgent_command);
+    bool is_pending(const uint8_t command) const;
+    bool is_blocked() const;
+    void transmit(request_t &request);
+    void check_timeouts();
+    void process_requests();
 
 public:
     RmdMotor(const std::string name, const Can_ptr can, const uint8_t motor_id, const int ratio);
     void subscribe_to_can();
     void step() override;
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Property> &get_property_table() const override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
     void handle_can_msg(const uint32_t id, const int count, const uint8_t *const data) override;
 
     bool power(double target_power);
@@ -38,7 +89,16 @@ public:
     bool hold();
     bool clear_errors();
 
-    double get_position() const;
-    double get_speed() const;
+    number_t get_position() const;
+    number_t get_speed() const;
     bool set_acceleration(const uint8_t index, const uint32_t acceleration);
+    bool is_requested(const uint8_t command) const;
+    unsigned int get_aborted_count() const;
+    void set_polled_by_group(const bool is_polled_by_group);
+
+    static rmd_payload_t power_request(const double target_power);
+    static rmd_payload_t speed_request(const double target_speed);
+    static rmd_payload_t position_request(const double target_position, const double target_speed = 0.0);
+    static bool covers_bus(const std::vector<RmdMotor_ptr> &motors);
+    static bool send_to_all(const std::vector<RmdMotor_ptr> &motors, const std::vector<rmd_payload_t> &payloads, const bool is_urgent = false);
 };
\ No newline at end of file
@@ -5,15 +5,31 @@
 
 class RmdPair : public Module {
 private:
+    enum class MethodId : unsigned int {
+        move = Module::method_count,
+        stop,
+        off,
+        hold,
+        clear_errors,
+        count,
+    };
+    static const std::vector<Method> methods;
+    enum class PropertyId : unsigned int {
+        v_max,
+        a_max,
+        count,
+    };
+    static const std::vector<Property> property_table;
     const RmdMotor_ptr rmd1;
     const RmdMotor_ptr rmd2;
+    unsigned int aborted_count;
 
     struct TrajectoryPart {
-        double t0;
-        double x0;
-        double v0;
-        double a;
-        double dt;
+        number_t t0;
+        number_t x0;
+        number_t v0;
+        number_t a;
+        number_t dt;
     };
 
     struct TrajectoryTriple {
@@ -22,11 +38,14 @@ private:
         TrajectoryPart part_c;
     };
 
-    void throttle(TrajectoryPart &part, double factor) const;
-    TrajectoryTriple compute_trajectory(double x0, double x1, double v0, double v1) const;
-    void move(double x, double y);
+    void throttle(TrajectoryPart &part, number_t factor) const;
+    TrajectoryTriple compute_trajectory(number_t x0, number_t x1, number_t v0, number_t v1) const;
+    void move(number_t x, number_t y);
 
 public:
     RmdPair(const std::string name, const RmdMotor_ptr rmd1, const RmdMotor_ptr rmd2);
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    void step() override;
+    const std::vector<Property> &get_property_table() const override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
 };
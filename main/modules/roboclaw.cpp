@@ -5,16 +5,24 @@
 #define SetDWORDval(arg) (uint8_t)(((uint32_t)arg) >> 24), (uint8_t)(((uint32_t)arg) >> 16), (uint8_t)(((uint32_t)arg) >> 8), (uint8_t)arg
 #define SetWORDval(arg) (uint8_t)(((uint16_t)arg) >> 8), (uint8_t)arg
 
+const std::vector<Property> RoboClaw::property_table = create_property_table<PropertyId::count>({
+    {"temperature", number},
+});
+
+const std::vector<Property> &RoboClaw::get_property_table() const {
+    return RoboClaw::property_table;
+}
+
 RoboClaw::RoboClaw(const std::string name, const ConstSerial_ptr serial, const uint8_t address)
     : Module(roboclaw, name), address(address), serial(serial) {
-    this->properties["temperature"] = std::make_shared<NumberVariable>();
+    this->create_properties();
 }
 
 void RoboClaw::step() {
     if (millis_since(this->last_temp_reading) > 1000) {
         uint16_t temp;
         this->ReadTemp(temp);
-        this->properties["temperature"]->number_value = temp / 10.0;
+        this->property(PropertyId::temperature)->set_number(temp / 10.0);
         this->last_temp_reading = millis();
     }
     Module::step();
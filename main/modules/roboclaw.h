@@ -13,6 +13,11 @@ class RoboClaw;
 using RoboClaw_ptr = std::shared_ptr<RoboClaw>;
 
 class RoboClaw : public Module {
+    enum class PropertyId : unsigned int {
+        temperature,
+        count,
+    };
+    static const std::vector<Property> property_table;
     uint16_t crc;
     const uint32_t timeout = 5; // [ticks]
     const uint8_t address;
@@ -116,6 +121,7 @@ class RoboClaw : public Module {
 
 public:
     RoboClaw(const std::string name, const ConstSerial_ptr serial, const uint8_t address);
+    const std::vector<Property> &get_property_table() const override;
     void step() override;
 
     bool ForwardM1(uint8_t speed);
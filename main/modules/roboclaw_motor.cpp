@@ -3,12 +3,20 @@
 
 #define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
 
+const std::vector<Property> RoboClawMotor::property_table = create_property_table<PropertyId::count>({
+    {"position", integer},
+});
+
+const std::vector<Property> &RoboClawMotor::get_property_table() const {
+    return RoboClawMotor::property_table;
+}
+
 RoboClawMotor::RoboClawMotor(const std::string name, const RoboClaw_ptr roboclaw, const unsigned int motor_number)
     : Module(roboclaw_motor, name), motor_number(constrain(motor_number, 1, 2)), roboclaw(roboclaw) {
     if (this->motor_number != motor_number) {
         throw std::runtime_error("illegal motor number");
     }
-    this->properties["position"] = std::make_shared<IntegerVariable>();
+    this->create_properties();
 }
 
 void RoboClawMotor::step() {
@@ -18,29 +26,42 @@ void RoboClawMotor::step() {
     if (!valid) {
         throw std::runtime_error("could not read motor position");
     }
-    this->properties["position"]->integer_value = position;
+    this->property(PropertyId::position)->set_integer(position);
     Module::step();
 }
 
-void RoboClawMotor::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (method_name == "power") {
-        Module::expect(arguments, 1, numbery);
+const std::vector<Method> RoboClawMotor::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"power", {numbery}},
+    {"speed", {numbery}},
+    {"zero", 0, -1},
+});
+
+const std::vector<Method> &RoboClawMotor::get_methods() const {
+    return RoboClawMotor::methods;
+}
+
+void RoboClawMotor::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::power:
         this->power(arguments[0]->evaluate_number());
-    } else if (method_name == "speed") {
-        Module::expect(arguments, 1, numbery);
+        break;
+    case MethodId::speed:
         this->speed(arguments[0]->evaluate_number());
-    } else if (method_name == "zero") {
+        break;
+    case MethodId::zero: {
         bool success = this->motor_number == 1 ? this->roboclaw->SetEncM1(0) : this->roboclaw->SetEncM2(0);
         if (!success) {
             throw std::runtime_error("could not reset position");
         }
-    } else {
-        Module::call(method_name, arguments);
+        break;
+    }
+    default:
+        Module::call(method_id, arguments);
     }
 }
 
 int64_t RoboClawMotor::get_position() const {
-    return this->properties.at("position")->integer_value;
+    return this->property(PropertyId::position)->integer_value;
 }
 
 void RoboClawMotor::power(double value) {
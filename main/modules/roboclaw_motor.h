@@ -8,13 +8,27 @@ using RoboClawMotor_ptr = std::shared_ptr<RoboClawMotor>;
 
 class RoboClawMotor : public Module {
 private:
+    enum class MethodId : unsigned int {
+        power = Module::method_count,
+        speed,
+        zero,
+        count,
+    };
+    static const std::vector<Method> methods;
+    enum class PropertyId : unsigned int {
+        position,
+        count,
+    };
+    static const std::vector<Property> property_table;
     const unsigned int motor_number;
     const RoboClaw_ptr roboclaw;
 
 public:
     RoboClawMotor(const std::string name, const RoboClaw_ptr roboclaw, const unsigned int motor_number);
     void step() override;
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Property> &get_property_table() const override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
 
     int64_t get_position() const;
     void power(double value);
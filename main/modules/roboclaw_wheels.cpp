@@ -2,13 +2,24 @@
 #include "../utils/timing.h"
 #include <memory>
 
+const std::vector<Property> RoboClawWheels::property_table = create_property_table<PropertyId::count>({
+    {"width", number},
+    {"linear_speed", number},
+    {"angular_speed", number},
+    {"enabled", boolean},
+    {"m_per_tick", number},
+});
+
+const std::vector<Property> &RoboClawWheels::get_property_table() const {
+    return RoboClawWheels::property_table;
+}
+
 RoboClawWheels::RoboClawWheels(const std::string name, const RoboClawMotor_ptr left_motor, const RoboClawMotor_ptr right_motor)
     : Module(roboclaw_wheels, name), left_motor(left_motor), right_motor(right_motor) {
-    this->properties["width"] = std::make_shared<NumberVariable>(1);
-    this->properties["linear_speed"] = std::make_shared<NumberVariable>();
-    this->properties["angular_speed"] = std::make_shared<NumberVariable>();
-    this->properties["enabled"] = std::make_shared<BooleanVariable>(true);
-    this->properties["m_per_tick"] = std::make_shared<NumberVariable>(1);
+    this->create_properties();
+    this->property(PropertyId::width)->set_number(1);
+    this->property(PropertyId::enabled)->set_boolean(true);
+    this->property(PropertyId::m_per_tick)->set_number(1);
 }
 
 /* Catch unsigned wrap-around by detecting large jumps in encoder deltas */
@@ -30,11 +41,11 @@ void RoboClawWheels::step() {
         double d_right_position = difference_wrapped_u32(right_position, last_right_position);
 
         unsigned long int d_micros = micros_since(last_micros);
-        const double m_per_tick = this->properties.at("m_per_tick")->number_value;
+        const double m_per_tick = this->property(PropertyId::m_per_tick)->number_value;
         double left_speed = (d_left_position * m_per_tick) / d_micros * 1000000;
         double right_speed = (d_right_position * m_per_tick) / d_micros * 1000000;
-        this->properties.at("linear_speed")->number_value = (left_speed + right_speed) / 2;
-        this->properties.at("angular_speed")->number_value = (right_speed - left_speed) / this->properties.at("width")->number_value;
+        this->property(PropertyId::linear_speed)->set_number((left_speed + right_speed) / 2);
+        this->property(PropertyId::angular_speed)->set_number((right_speed - left_speed) / this->property(PropertyId::width)->number_value);
     }
 
     last_micros = micros();
@@ -45,28 +56,39 @@ void RoboClawWheels::step() {
     Module::step();
 }
 
-void RoboClawWheels::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (method_name == "power") {
-        Module::expect(arguments, 2, numbery, numbery);
-        if (this->properties.at("enabled")->boolean_value) {
+const std::vector<Method> RoboClawWheels::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"power", {numbery, numbery}},
+    {"speed", {numbery, numbery}},
+    {"off"},
+});
+
+const std::vector<Method> &RoboClawWheels::get_methods() const {
+    return RoboClawWheels::methods;
+}
+
+void RoboClawWheels::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::power:
+        if (this->property(PropertyId::enabled)->boolean_value) {
             this->left_motor->power(arguments[0]->evaluate_number());
             this->right_motor->power(arguments[1]->evaluate_number());
         }
-    } else if (method_name == "speed") {
-        Module::expect(arguments, 2, numbery, numbery);
-        if (this->properties.at("enabled")->boolean_value) {
+        break;
+    case MethodId::speed:
+        if (this->property(PropertyId::enabled)->boolean_value) {
             double linear = arguments[0]->evaluate_number();
             double angular = arguments[1]->evaluate_number();
-            const double half_width = this->properties.at("width")->number_value / 2.0;
-            const double m_per_tick = this->properties.at("m_per_tick")->number_value;
+            const double half_width = this->property(PropertyId::width)->number_value / 2.0;
+            const double m_per_tick = this->property(PropertyId::m_per_tick)->number_value;
             this->left_motor->speed((linear - angular * half_width) / m_per_tick);
             this->right_motor->speed((linear + angular * half_width) / m_per_tick);
         }
-    } else if (method_name == "off") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::off:
         this->left_motor->power(0);
         this->right_motor->power(0);
-    } else {
-        Module::call(method_name, arguments);
+        break;
+    default:
+        Module::call(method_id, arguments);
     }
 }
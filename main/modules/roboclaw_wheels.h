@@ -4,6 +4,22 @@
 
 class RoboClawWheels : public Module {
 private:
+    enum class MethodId : unsigned int {
+        power = Module::method_count,
+        speed,
+        off,
+        count,
+    };
+    static const std::vector<Method> methods;
+    enum class PropertyId : unsigned int {
+        width,
+        linear_speed,
+        angular_speed,
+        enabled,
+        m_per_tick,
+        count,
+    };
+    static const std::vector<Property> property_table;
     const RoboClawMotor_ptr left_motor;
     const RoboClawMotor_ptr right_motor;
 
@@ -15,5 +31,7 @@ private:
 public:
     RoboClawWheels(const std::string name, const RoboClawMotor_ptr left_motor, const RoboClawMotor_ptr right_motor);
     void step() override;
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Property> &get_property_table() const override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
 };
@@ -112,18 +112,31 @@ std::string Serial::get_output() const {
     return buffer;
 }
 
-void Serial::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (method_name == "send") {
+const std::vector<Method> Serial::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"send", 0, -1},
+    {"read", 0, -1},
+});
+
+const std::vector<Method> &Serial::get_methods() const {
+    return Serial::methods;
+}
+
+void Serial::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::send:
         for (auto const &argument : arguments) {
             if ((argument->type & integer) == 0) {
                 throw std::runtime_error("type mismatch at argument");
             }
             this->write(argument->evaluate_integer());
         }
-    } else if (method_name == "read") {
+        break;
+    case MethodId::read: {
         const std::string output = this->get_output();
         echo("%s %s", this->name.c_str(), output.c_str());
-    } else {
-        Module::call(method_name, arguments);
+        break;
+    }
+    default:
+        Module::call(method_id, arguments);
     }
 }
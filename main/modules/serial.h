@@ -11,6 +11,14 @@ using Serial_ptr = std::shared_ptr<Serial>;
 using ConstSerial_ptr = std::shared_ptr<const Serial>;
 
 class Serial : public Module {
+private:
+    enum class MethodId : unsigned int {
+        send = Module::method_count,
+        read,
+        count,
+    };
+    static const std::vector<Method> methods;
+
 public:
     const gpio_num_t rx_pin;
     const gpio_num_t tx_pin;
@@ -30,5 +38,6 @@ public:
     void flush() const;
     void clear() const;
     std::string get_output() const override;
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
 };
@@ -9,6 +9,16 @@
 
 #define MIN_SPEED 490
 
+const std::vector<Property> StepperMotor::property_table = create_property_table<PropertyId::count>({
+    {"position", integer},
+    {"speed", integer},
+    {"idle", boolean},
+});
+
+const std::vector<Property> &StepperMotor::get_property_table() const {
+    return StepperMotor::property_table;
+}
+
 StepperMotor::StepperMotor(const std::string name,
                            const gpio_num_t step_pin,
                            const gpio_num_t dir_pin,
@@ -26,9 +36,8 @@ StepperMotor::StepperMotor(const std::string name,
     gpio_reset_pin(step_pin);
     gpio_reset_pin(dir_pin);
 
-    this->properties["position"] = std::make_shared<IntegerVariable>();
-    this->properties["speed"] = std::make_shared<IntegerVariable>();
-    this->properties["idle"] = std::make_shared<BooleanVariable>(true);
+    this->create_properties();
+    this->property(PropertyId::idle)->set_boolean(true);
 
     pcnt_config_t pcnt_config = {
         .pulse_gpio_num = step_pin,
@@ -81,13 +90,13 @@ void StepperMotor::read_position() {
     if (d_count < -15000) {
         d_count += 30000;
     }
-    this->properties.at("position")->integer_value += d_count;
+    this->property(PropertyId::position)->set_integer(this->property(PropertyId::position)->integer_value + d_count);
     this->last_count = count;
 }
 
 void StepperMotor::set_state(StepperState new_state) {
     this->state = new_state;
-    this->properties.at("idle")->boolean_value = (new_state == Idle);
+    this->property(PropertyId::idle)->set_boolean(new_state == Idle);
     ledc_set_duty(LEDC_HIGH_SPEED_MODE, this->ledc_channel, new_state == Idle ? 0 : 1);
     ledc_update_duty(LEDC_HIGH_SPEED_MODE, this->ledc_channel);
 }
@@ -96,13 +105,13 @@ void StepperMotor::step() {
     this->read_position();
 
     // time since last call
-    double dt = micros_since(this->last_micros) * 1e-6;
+    number_t dt = micros_since(this->last_micros) * (number_t)1e-6;
     this->last_micros = micros();
 
     if (this->state != Idle) {
         // current state
-        int32_t position = this->properties.at("position")->integer_value;
-        int32_t speed = this->properties.at("speed")->integer_value;
+        int32_t position = this->property(PropertyId::position)->integer_value;
+        int32_t speed = this->property(PropertyId::speed)->integer_value;
 
         // current target speed
         int32_t target_speed = this->target_speed;
@@ -113,8 +122,8 @@ void StepperMotor::step() {
                     this->target_speed = target_speed = 0;
                 }
             } else {
-                double squared_speed = (double)speed * speed;
-                int32_t braking_distance = squared_speed / this->target_acceleration / 2.0;
+                number_t squared_speed = (number_t)speed * speed;
+                int32_t braking_distance = squared_speed / this->target_acceleration / 2;
                 int32_t remaining_distance = this->target_position - position;
                 if (std::abs(remaining_distance) < std::abs(braking_distance)) {
                     this->target_speed = target_speed = 0;
@@ -126,7 +135,7 @@ void StepperMotor::step() {
         if (this->target_acceleration == 0) {
             speed = target_speed;
         } else {
-            int32_t d_speed = std::max(dt * (double)this->target_acceleration, 1.0);
+            int32_t d_speed = std::max(dt * (number_t)this->target_acceleration, (number_t)1);
             if (speed < target_speed) {
                 speed = std::min(speed + d_speed, target_speed);
             } else if (speed > target_speed) {
@@ -149,35 +158,40 @@ void StepperMotor::step() {
             set_state(Idle);
         }
 
-        this->properties.at("speed")->integer_value = speed;
+        this->property(PropertyId::speed)->set_integer(speed);
     } else {
-        this->properties.at("speed")->integer_value = 0;
+        this->property(PropertyId::speed)->set_integer(0);
     }
 
     Module::step();
 }
 
-void StepperMotor::call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) {
-    if (method_name == "position") {
-        if (arguments.size() < 2 || arguments.size() > 3) {
-            throw std::runtime_error("unexpected number of arguments");
-        }
-        Module::expect(arguments, -1, numbery, numbery, numbery);
+const std::vector<Method> StepperMotor::methods = create_method_table<Module::method_count, MethodId::count>({
+    {"position", 2, 3, {numbery, numbery, numbery}},
+    {"speed", 1, 2, {numbery, numbery}},
+    {"stop"},
+});
+
+const std::vector<Method> &StepperMotor::get_methods() const {
+    return StepperMotor::methods;
+}
+
+void StepperMotor::call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) {
+    switch (static_cast<MethodId>(method_id)) {
+    case MethodId::position:
         this->position(arguments[0]->evaluate_number(),
                        arguments[1]->evaluate_number(),
                        arguments.size() > 2 ? std::abs(arguments[2]->evaluate_number()) : 0);
-    } else if (method_name == "speed") {
-        if (arguments.size() < 1 || arguments.size() > 2) {
-            throw std::runtime_error("unexpected number of arguments");
-        }
-        Module::expect(arguments, -1, numbery, numbery);
+        break;
+    case MethodId::speed:
         this->speed(arguments[0]->evaluate_number(),
                     arguments.size() > 1 ? std::abs(arguments[1]->evaluate_number()) : 0);
-    } else if (method_name == "stop") {
-        Module::expect(arguments, 0);
+        break;
+    case MethodId::stop:
         this->stop();
-    } else {
-        Module::call(method_name, arguments);
+        break;
+    default:
+        Module::call(method_id, arguments);
     }
 }
 
@@ -185,23 +199,23 @@ void StepperMotor::stop() {
     set_state(Idle);
 }
 
-double StepperMotor::get_position() {
-    return static_cast<double>(this->properties.at("position")->integer_value);
+number_t StepperMotor::get_position() {
+    return static_cast<number_t>(this->property(PropertyId::position)->integer_value);
 }
 
-void StepperMotor::position(const double position, const double speed, const double acceleration) {
+void StepperMotor::position(const number_t position, const number_t speed, const number_t acceleration) {
     this->target_position = static_cast<int32_t>(position);
-    bool forward = this->target_position > this->properties.at("position")->integer_value;
+    bool forward = this->target_position > this->property(PropertyId::position)->integer_value;
     this->target_speed = static_cast<int32_t>(speed) * (forward ? 1 : -1);
     this->target_acceleration = static_cast<uint32_t>(acceleration);
     set_state(Positioning);
 }
 
-double StepperMotor::get_speed() {
-    return static_cast<double>(this->properties.at("speed")->integer_value);
+number_t StepperMotor::get_speed() {
+    return static_cast<number_t>(this->property(PropertyId::speed)->integer_value);
 }
 
-void StepperMotor::speed(const double speed, const double acceleration) {
+void StepperMotor::speed(const number_t speed, const number_t acceleration) {
     this->target_speed = static_cast<int32_t>(speed);
     this->target_acceleration = static_cast<uint32_t>(acceleration);
     set_state(this->target_speed == 0 ? Idle : Speeding);
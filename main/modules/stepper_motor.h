@@ -17,6 +17,20 @@ using StepperMotor_ptr = std::shared_ptr<StepperMotor>;
 
 class StepperMotor : public Module, virtual public Motor {
 private:
+    enum class MethodId : unsigned int {
+        position = Module::method_count,
+        speed,
+        stop,
+        count,
+    };
+    static const std::vector<Method> methods;
+    enum class PropertyId : unsigned int {
+        position,
+        speed,
+        idle,
+        count,
+    };
+    static const std::vector<Property> property_table;
     const gpio_num_t step_pin;
     const gpio_num_t dir_pin;
     const pcnt_unit_t pcnt_unit;
@@ -44,7 +58,9 @@ public:
                  const ledc_timer_t ledc_timer,
                  const ledc_channel_t ledc_channel);
     void step() override;
-    void call(const std::string method_name, const std::vector<ConstExpression_ptr> arguments) override;
+    const std::vector<Property> &get_property_table() const override;
+    const std::vector<Method> &get_methods() const override;
+    void call(const unsigned int method_id, const std::vector<ConstExpression_ptr> arguments) override;
 
     StepperState get_state() const { return this->state; }
     int32_t get_target_position() const { return this->target_position; }
@@ -52,8 +68,8 @@ public:
     uint32_t get_target_acceleration() const { return this->target_acceleration; }
 
     void stop() override;
-    double get_position() override;
-    void position(const double position, const double speed, const double acceleration) override;
-    double get_speed() override;
-    void speed(const double speed, const double acceleration) override;
+    number_t get_position() override;
+    void position(const number_t position, const number_t speed, const number_t acceleration) override;
+    number_t get_speed() override;
+    void speed(const number_t speed, const number_t acceleration) override;
 };
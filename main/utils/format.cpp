@@ -0,0 +1,129 @@
+#include "format.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+static const uint64_t powers_of_ten[] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+};
+static const unsigned int max_precision = 9;
+
+static int write_digits(char *buffer, uint64_t value, const unsigned int min_digits) {
+    char digits[20];
+    unsigned int count = 0;
+    while (value > 0 || count < min_digits) {
+        digits[count++] = '0' + value % 10;
+        value /= 10;
+    }
+    for (unsigned int i = 0; i < count; ++i) {
+        buffer[i] = digits[count - 1 - i];
+    }
+    return count;
+}
+
+int format_integer(char *buffer, const int64_t value) {
+    int pos = 0;
+    uint64_t magnitude = value;
+    if (value < 0) {
+        buffer[pos++] = '-';
+        magnitude = 0 - magnitude;
+    }
+    pos += write_digits(&buffer[pos], magnitude, 1);
+    buffer[pos] = '\0';
+    return pos;
+}
+
+// computes round(value * 10^precision) exactly, returns false if the result does not fit into 63 bits
+static bool scale_and_round(const double value, const unsigned int precision, uint64_t &result) {
+    if (!(value < 9e18 / powers_of_ten[precision])) {
+        return false;
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const int exponent_bits = (bits >> 52) & 0x7ff;
+    uint64_t mantissa = bits & ((1ULL << 52) - 1);
+    int exponent = exponent_bits == 0 ? -1074 : exponent_bits - 1075;
+    if (exponent_bits != 0) {
+        mantissa |= 1ULL << 52;
+    }
+
+    // value * 10^precision = mantissa * 5^precision * 2^(exponent + precision) with a product of less than 75 bits
+    const uint64_t factor = powers_of_ten[precision] >> precision;
+    const uint64_t low_product = (mantissa & 0xffffffff) * factor;
+    const uint64_t high_product = (mantissa >> 32) * factor;
+    uint64_t low = low_product + (high_product << 32);
+    uint64_t high = (high_product >> 32) + (low < low_product ? 1 : 0);
+    exponent += precision;
+
+    if (exponent >= 0) {
+        result = low << exponent;
+        return true;
+    }
+    const int shift = -exponent;
+    if (shift > 75) {
+        result = 0;
+        return true;
+    }
+    const int round_bit = shift - 1;
+    const bool is_round_bit_set = round_bit < 64 ? (low >> round_bit) & 1 : (high >> (round_bit - 64)) & 1;
+    bool has_sticky_bits;
+    if (round_bit < 64) {
+        has_sticky_bits = (low & ((1ULL << round_bit) - 1)) != 0;
+    } else {
+        has_sticky_bits = low != 0 || (high & ((1ULL << (round_bit - 64)) - 1)) != 0;
+    }
+    if (shift < 64) {
+        result = (low >> shift) | (high << (64 - shift));
+    } else {
+        result = high >> (shift - 64);
+    }
+    if (is_round_bit_set && (has_sticky_bits || (result & 1))) {
+        result++;
+    }
+    return true;
+}
+
+int format_number(char *buffer, const double value, const unsigned int precision) {
+    uint64_t scaled;
+    if (!std::isfinite(value) || precision > max_precision || !scale_and_round(std::fabs(value), precision, scaled)) {
+        return sprintf(buffer, "%.*f", precision, value);
+    }
+    int pos = 0;
+    if (std::signbit(value)) {
+        buffer[pos++] = '-';
+    }
+    pos += write_digits(&buffer[pos], scaled / powers_of_ten[precision], 1);
+    if (precision > 0) {
+        buffer[pos++] = '.';
+        pos += write_digits(&buffer[pos], scaled % powers_of_ten[precision], precision);
+    }
+    buffer[pos] = '\0';
+    return pos;
+}
+
+int format_number_shortest(char *buffer, const number_t value) {
+    if (std::isfinite(value)) {
+        for (unsigned int precision = 1; precision <= max_precision; ++precision) {
+            const int length = format_number(buffer, value, precision);
+            if ((number_t)strtod(buffer, nullptr) == value) {
+                return length;
+            }
+        }
+    }
+    int length = sprintf(buffer, "%.*g", std::numeric_limits<number_t>::max_digits10, value);
+    if (std::strpbrk(buffer, ".en") == nullptr) {
+        length += sprintf(&buffer[length], ".0");
+    }
+    return length;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "../compilation/type.h"
+#include <stdint.h>
+
+// these functions write a null-terminated string and return its length like sprintf
+
+int format_integer(char *buffer, const int64_t value);
+
+int format_number(char *buffer, const double value, const unsigned int precision);
+
+// shortest representation that parses back to the same value
+int format_number_shortest(char *buffer, const number_t value);
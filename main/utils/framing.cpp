@@ -0,0 +1,31 @@
+#include "framing.h"
+
+uint16_t crc16(const uint8_t *data, const size_t length) {
+    uint16_t crc = 0xffff;
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+size_t cobs_encode(const uint8_t *input, const size_t length, uint8_t *output) {
+    size_t code_pos = 0;
+    size_t out_pos = 1;
+    uint8_t code = 1;
+    for (size_t i = 0; i < length; ++i) {
+        if (input[i] != 0) {
+            output[out_pos++] = input[i];
+            code++;
+        }
+        if (input[i] == 0 || code == 0xff) {
+            output[code_pos] = code;
+            code_pos = out_pos++;
+            code = 1;
+        }
+    }
+    output[code_pos] = code;
+    return out_pos;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+uint16_t crc16(const uint8_t *data, const size_t length);
+
+size_t cobs_encode(const uint8_t *input, const size_t length, uint8_t *output);
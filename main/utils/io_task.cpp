@@ -0,0 +1,11 @@
+#include "io_task.h"
+#include <stdexcept>
+#include <string>
+
+TaskHandle_t start_io_task(TaskFunction_t function, const char *name, void *arg, const UBaseType_t priority) {
+    TaskHandle_t task = nullptr;
+    if (xTaskCreatePinnedToCore(function, name, IO_TASK_STACK_SIZE, arg, priority, &task, IO_TASK_CORE) != pdPASS) {
+        throw std::runtime_error(std::string("could not start ") + name + " task");
+    }
+    return task;
+}
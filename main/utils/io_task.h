@@ -0,0 +1,10 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define IO_TASK_CORE 1
+#define IO_TASK_PRIORITY 5
+#define IO_TASK_STACK_SIZE 4096
+
+TaskHandle_t start_io_task(TaskFunction_t function, const char *name, void *arg, const UBaseType_t priority = IO_TASK_PRIORITY);
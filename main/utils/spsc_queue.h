@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <vector>
+
+// lock-free ring buffer for exactly one producer and one consumer task
+template <typename T>
+class SpscQueue {
+private:
+    std::vector<T> buffer;
+    std::atomic<size_t> head{0};
+    std::atomic<size_t> tail{0};
+
+public:
+    SpscQueue(const size_t capacity) : buffer(capacity + 1) {
+    }
+
+    bool push(const T &item) {
+        const size_t tail = this->tail.load(std::memory_order_relaxed);
+        const size_t next = (tail + 1) % this->buffer.size();
+        if (next == this->head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        this->buffer[tail] = item;
+        this->tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &item) {
+        const size_t head = this->head.load(std::memory_order_relaxed);
+        if (head == this->tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = this->buffer[head];
+        this->head.store((head + 1) % this->buffer.size(), std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return this->head.load(std::memory_order_acquire) == this->tail.load(std::memory_order_acquire);
+    }
+};
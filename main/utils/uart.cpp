@@ -1,17 +1,125 @@
 #include "uart.h"
+#include "driver/uart.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/ringbuf.h"
+#include "freertos/task.h"
+#include "io_task.h"
+#include <atomic>
 #include <cstdarg>
+#include <mutex>
 #include <stdexcept>
 #include <stdio.h>
+#include <string.h>
 #include <string>
 
-void echo(const char *format, ...) {
+#define OUTPUT_BUFFER_SIZE 4096
+
+static RingbufHandle_t message_buffer = nullptr;
+static RingbufHandle_t telemetry_buffer = nullptr;
+static TaskHandle_t output_task = nullptr;
+static std::atomic<unsigned long int> tx_bytes_queued{0};
+static std::atomic<unsigned long int> tx_bytes_dropped{0};
+static std::atomic<size_t> message_bytes_pending{0};
+static std::mutex format_mutex;
+
+static bool write_next_item(const RingbufHandle_t buffer) {
+    static char chunk[OUTPUT_BUFFER_SIZE];
+    size_t size = 0;
+    void *item = xRingbufferReceive(buffer, &size, 0);
+    if (!item) {
+        return false;
+    }
+    memcpy(chunk, item, size);
+    vRingbufferReturnItem(buffer, item);
+    uart_write_bytes(UART_NUM_0, chunk, size);
+    if (buffer == message_buffer) {
+        message_bytes_pending -= size;
+    }
+    return true;
+}
+
+static void run_output_task(void *arg) {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (write_next_item(message_buffer) || write_next_item(telemetry_buffer)) {
+        }
+    }
+}
+
+void start_output_task() {
+    message_buffer = xRingbufferCreate(OUTPUT_BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT);
+    telemetry_buffer = xRingbufferCreate(OUTPUT_BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT);
+    if (!message_buffer || !telemetry_buffer) {
+        throw std::runtime_error("could not create output buffers");
+    }
+#ifdef CONFIG_LIZARD_BUS_IO_TASKS
+    output_task = start_io_task(run_output_task, "uart_output", nullptr);
+#else
+    if (xTaskCreate(run_output_task, "uart_output", 4096, nullptr, 5, &output_task) != pdPASS) {
+        throw std::runtime_error("could not start uart_output task");
+    }
+#endif
+}
+
+unsigned long int get_tx_bytes_queued() {
+    return tx_bytes_queued;
+}
+
+unsigned long int get_tx_bytes_dropped() {
+    return tx_bytes_dropped;
+}
+
+void set_baud_rate(const uint32_t baud_rate) {
+    // earlier messages have to leave the UART with the previous baud rate
+    const TickType_t start = xTaskGetTickCount();
+    while (output_task && message_bytes_pending > 0 && xTaskGetTickCount() - start < pdMS_TO_TICKS(1000)) {
+        vTaskDelay(1);
+    }
+    uart_wait_tx_done(UART_NUM_0, pdMS_TO_TICKS(1000));
+    if (uart_set_baudrate(UART_NUM_0, baud_rate) != ESP_OK) {
+        throw std::runtime_error("could not set baud rate");
+    }
+}
+
+static void write_line(const char *line, const size_t length, const bool is_telemetry) {
+    if (!output_task) {
+        uart_write_bytes(UART_NUM_0, line, length);
+        return;
+    }
+    if (is_telemetry) {
+        while (xRingbufferSend(telemetry_buffer, line, length, 0) != pdTRUE) {
+            size_t size = 0;
+            void *item = xRingbufferReceive(telemetry_buffer, &size, 0);
+            if (!item) {
+                tx_bytes_dropped += length;
+                return;
+            }
+            vRingbufferReturnItem(telemetry_buffer, item);
+            tx_bytes_dropped += size;
+        }
+    } else {
+        message_bytes_pending += length;
+        xRingbufferSend(message_buffer, line, length, portMAX_DELAY);
+    }
+    tx_bytes_queued += length;
+    xTaskNotifyGive(output_task);
+}
+
+void write_message(const char *text) {
+    write_line(text, strlen(text), false);
+}
+
+void write_telemetry(const uint8_t *data, const size_t length) {
+    write_line((const char *)data, length, true);
+}
+
+static void write_lines(const bool is_telemetry, const char *format, va_list args) {
+    const std::lock_guard<std::mutex> lock(format_mutex);
     static char buffer[1024];
+    static char line[1024 + 4];
     int pos = 0;
 
-    va_list args;
-    va_start(args, format);
     pos += std::vsnprintf(&buffer[pos], sizeof buffer - pos - 1, format, args);
-    va_end(args);
 
     pos += std::sprintf(&buffer[pos], "\n");
 
@@ -20,7 +128,8 @@ void echo(const char *format, ...) {
     for (unsigned int i = 0; i < pos; ++i) {
         if (buffer[i] == '\n') {
             buffer[i] = '\0';
-            printf("%s@%02x\n", &buffer[start], checksum);
+            const int length = std::sprintf(line, "%s@%02x\n", &buffer[start], checksum);
+            write_line(line, length, is_telemetry);
             start = i + 1;
             checksum = 0;
         } else {
@@ -29,6 +138,20 @@ void echo(const char *format, ...) {
     }
 }
 
+void echo(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    write_lines(false, format, args);
+    va_end(args);
+}
+
+void echo_telemetry(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    write_lines(true, format, args);
+    va_end(args);
+}
+
 int strip(char *buffer, int len) {
     while (buffer[len - 1] == ' ' ||
            buffer[len - 1] == '\t' ||
@@ -1,5 +1,16 @@
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
+void start_output_task();
+unsigned long int get_tx_bytes_queued();
+unsigned long int get_tx_bytes_dropped();
+void set_baud_rate(const uint32_t baud_rate);
+
 void echo(const char *fmt, ...);
+void echo_telemetry(const char *fmt, ...);
+void write_message(const char *text);
+void write_telemetry(const uint8_t *data, const size_t length);
 int strip(char *buffer, int len);
 int check(char *buffer, int len);
@@ -1,12 +1,14 @@
 #!/usr/bin/env python3
+import argparse
 import asyncio
 import os.path
-import sys
 
 import serial
 from prompt_toolkit import PromptSession
 from prompt_toolkit.patch_stdout import patch_stdout
 
+from baud import switch_baud_rate
+
 
 class LineReader:
     # https://github.com/pyserial/pyserial/issues/216#issuecomment-369414522
@@ -73,10 +75,8 @@ async def send() -> None:
             return
 
 
-def serial_connection() -> serial.Serial:
-    if len(sys.argv) > 1:
-        usb_path = sys.argv[1]
-    else:
+def serial_connection(usb_path: str) -> serial.Serial:
+    if not usb_path:
         usb_paths = [
             '/dev/ttyTHS0',
             '/dev/ttyTHS1',
@@ -96,7 +96,14 @@ def serial_connection() -> serial.Serial:
 
 
 if __name__ == '__main__':
-    with serial_connection() as port:
+    parser = argparse.ArgumentParser(description='Lizard serial monitor')
+    parser.add_argument('device_path', nargs='?', help='serial device (default: first one found)')
+    parser.add_argument('--baud', type=int, help='switch to this baud rate after connecting')
+    args = parser.parse_args()
+
+    with serial_connection(args.device_path) as port:
+        if args.baud:
+            switch_baud_rate(port, args.baud)
         loop = asyncio.get_event_loop_policy().get_event_loop()
         loop.create_task(send())
         loop.run_in_executor(None, receive)
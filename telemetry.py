@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+import struct
+import sys
+from typing import Dict, List, Optional, Tuple
+
+import serial
+
+from baud import switch_baud_rate
+
+
+def crc16(data: bytes) -> int:
+    """CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xffff)"""
+    crc = 0xffff
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021 if crc & 0x8000 else crc << 1) & 0xffff
+    return crc
+
+
+def cobs_decode(data: bytes) -> bytes:
+    output = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data) + 1:
+            raise ValueError('invalid COBS data')
+        output.extend(data[i + 1:i + code])
+        i += code
+        if code < 0xff and i < len(data):
+            output.append(0)
+    return bytes(output)
+
+
+class TelemetryDecoder:
+    """Splits the serial stream into text lines and binary frames of `core.output_binary()`.
+
+    In delta mode the decoder keeps the last values and returns the complete state for each frame.
+    """
+
+    def __init__(self) -> None:
+        self.buffer = bytearray()
+        self.schema_id: Optional[int] = None
+        self.names: List[str] = []
+        self.formats: List[str] = []
+        self.is_delta = False
+        self.values: Optional[List[object]] = None
+        self.sequence = 0
+
+    def feed(self, data: bytes) -> List[Tuple[str, object]]:
+        """Returns a list of ("line", str) and ("frame", dict) tuples."""
+        self.buffer.extend(data)
+        results: List[Tuple[str, object]] = []
+        while self.buffer:
+            if self.buffer[0] == 0:
+                end = self.buffer.find(b'\x00', 1)
+                if end < 0:
+                    break
+                frame = bytes(self.buffer[1:end])
+                del self.buffer[:end + 1]
+                if frame:
+                    values = self.decode_frame(frame)
+                    if values is not None:
+                        results.append(('frame', values))
+            else:
+                end = self.buffer.find(b'\n')
+                zero = self.buffer.find(b'\x00')
+                if 0 <= zero and (end < 0 or zero < end):
+                    del self.buffer[:zero]
+                    continue
+                if end < 0:
+                    break
+                line = self.buffer[:end].decode(errors='replace').strip('\r')
+                del self.buffer[:end + 1]
+                line = self.check(line)
+                if line is not None:
+                    self.parse_schema(line)
+                    results.append(('line', line))
+        return results
+
+    @staticmethod
+    def check(line: str) -> Optional[str]:
+        if line[-3:-2] == '@':
+            checksum = 0
+            for c in line[:-3]:
+                checksum ^= ord(c)
+            if checksum != int(line[-2:], 16):
+                return None
+            line = line[:-3]
+        return line
+
+    def parse_schema(self, line: str) -> None:
+        words = line.split()
+        if len(words) < 2 or words[0] != 'schema':
+            return
+        self.schema_id = int(words[1])
+        self.is_delta = len(words) > 2 and words[2] == 'delta'
+        elements = words[3:] if self.is_delta else words[2:]
+        self.names = [element.rsplit(':', 1)[0] for element in elements]
+        self.formats = [element.rsplit(':', 1)[1] for element in elements]
+        self.values = None
+
+    def decode_frame(self, frame: bytes) -> Optional[Dict[str, object]]:
+        try:
+            payload = cobs_decode(frame)
+        except ValueError:
+            return None
+        if len(payload) < 3 or crc16(payload[:-2]) != struct.unpack('<H', payload[-2:])[0]:
+            return None
+        if payload[0] != self.schema_id:
+            return None
+        if not self.is_delta:
+            format_ = '<' + ''.join(self.formats)
+            if len(payload) - 3 != struct.calcsize(format_):
+                return None
+            return dict(zip(self.names, struct.unpack(format_, payload[1:-2])))
+
+        # delta frame: sequence number, bitmask of included values, included values
+        bitmask_size = (len(self.names) + 7) // 8
+        if len(payload) < 4 + bitmask_size:
+            return None
+        sequence = payload[1]
+        bitmask = payload[2:2 + bitmask_size]
+        included = [i for i in range(len(self.names)) if bitmask[i // 8] & (1 << (i % 8))]
+        format_ = '<' + ''.join(self.formats[i] for i in included)
+        if len(payload) - 4 - bitmask_size != struct.calcsize(format_):
+            return None
+        is_keyframe = len(included) == len(self.names)
+        if not is_keyframe and (self.values is None or sequence != (self.sequence + 1) % 256):
+            self.values = None
+            return None
+        if self.values is None:
+            self.values = [None] * len(self.names)
+        for i, value in zip(included, struct.unpack(format_, payload[2 + bitmask_size:-2])):
+            self.values[i] = value
+        self.sequence = sequence
+        return dict(zip(self.names, self.values))
+
+
+if __name__ == '__main__':
+    if len(sys.argv) not in [2, 3]:
+        print(f'Usage: {sys.argv[0]} <device_path> [<baud_rate>]')
+        exit()
+
+    decoder = TelemetryDecoder()
+    with serial.Serial(sys.argv[1], baudrate=115200, timeout=0.1) as port:
+        if len(sys.argv) == 3:
+            switch_baud_rate(port, int(sys.argv[2]))
+        while True:
+            for kind, value in decoder.feed(port.read(max(1, port.in_waiting))):
+                print(value)
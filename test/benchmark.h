@@ -0,0 +1,14 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+template <typename Function>
+void benchmark(const char *name, const int count, const Function function) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < count; ++n) {
+        function();
+    }
+    const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+    printf("%-40s %8.1f ns\n", name, duration.count() / count);
+}
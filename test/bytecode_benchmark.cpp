@@ -0,0 +1,33 @@
+#include "benchmark.h"
+#include "bytecode.h"
+
+static const std::shared_ptr<IntegerVariable> i = std::make_shared<IntegerVariable>(3);
+static const std::shared_ptr<NumberVariable> x = std::make_shared<NumberVariable>(1.5);
+static const std::shared_ptr<BooleanVariable> b = std::make_shared<BooleanVariable>(true);
+
+static volatile bool boolean_sink;
+static volatile number_t number_sink;
+
+int main() {
+    const ConstExpression_ptr i_ = std::make_shared<VariableExpression>(i);
+    const ConstExpression_ptr x_ = std::make_shared<VariableExpression>(x);
+    const ConstExpression_ptr b_ = std::make_shared<VariableExpression>(b);
+
+    const ConstExpression_ptr condition = std::make_shared<OrExpression>(
+        std::make_shared<AndExpression>(b_, std::make_shared<GreaterExpression>(x_, std::make_shared<NumberExpression>(1.0))),
+        std::make_shared<LessExpression>(i_, std::make_shared<IntegerExpression>(0)));
+    const ConstExpression_ptr setpoint = std::make_shared<AddExpression>(
+        std::make_shared<MultiplyExpression>(std::make_shared<SubtractExpression>(x_, std::make_shared<NumberExpression>(0.25)),
+                                             std::make_shared<NumberExpression>(2.5)),
+        std::make_shared<DivideExpression>(i_, std::make_shared<NumberExpression>(4.0)));
+    const ConstExpression_ptr condition_bytecode = BytecodeExpression::create(condition);
+    const ConstExpression_ptr setpoint_bytecode = BytecodeExpression::create(setpoint);
+
+    const int count = 10000000;
+    printf("number_t: %s\n", sizeof(number_t) == sizeof(float) ? "float" : "double");
+    benchmark("condition, tree", count, [&]() { boolean_sink = condition->evaluate_boolean(); });
+    benchmark("condition, bytecode", count, [&]() { boolean_sink = condition_bytecode->evaluate_boolean(); });
+    benchmark("setpoint, tree", count, [&]() { number_sink = setpoint->evaluate_number(); });
+    benchmark("setpoint, bytecode", count, [&]() { number_sink = setpoint_bytecode->evaluate_number(); });
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include "bytecode.h"
+#include "host.h"
+#include <cstdio>
+#include <stdexcept>
+
+static const std::shared_ptr<IntegerVariable> i = std::make_shared<IntegerVariable>();
+static const std::shared_ptr<NumberVariable> x = std::make_shared<NumberVariable>();
+static const std::shared_ptr<BooleanVariable> b = std::make_shared<BooleanVariable>();
+
+class BrokenExpression : public Expression {
+public:
+    BrokenExpression() : Expression(boolean) {
+    }
+};
+
+static ConstExpression_ptr integer_value(const int64_t value) {
+    return std::make_shared<IntegerExpression>(value);
+}
+
+static ConstExpression_ptr number_value(const number_t value) {
+    return std::make_shared<NumberExpression>(value);
+}
+
+static std::vector<ConstExpression_ptr> create_expressions() {
+    const ConstExpression_ptr i_ = std::make_shared<VariableExpression>(i);
+    const ConstExpression_ptr x_ = std::make_shared<VariableExpression>(x);
+    const ConstExpression_ptr b_ = std::make_shared<VariableExpression>(b);
+    const ConstExpression_ptr broken = std::make_shared<BrokenExpression>();
+    return {
+        std::make_shared<AddExpression>(std::make_shared<MultiplyExpression>(i_, integer_value(3)), integer_value(-7)),
+        std::make_shared<SubtractExpression>(std::make_shared<DivideExpression>(x_, number_value(4)), i_),
+        std::make_shared<DivideExpression>(integer_value(100), i_),
+        std::make_shared<ModuloExpression>(integer_value(100), i_),
+        std::make_shared<FloorDivideExpression>(x_, number_value(0.3)),
+        std::make_shared<ModuloExpression>(x_, number_value(0.7)),
+        std::make_shared<PowerExpression>(i_, integer_value(3)),
+        std::make_shared<PowerExpression>(x_, i_),
+        std::make_shared<NegateExpression>(std::make_shared<AddExpression>(x_, b_)),
+        std::make_shared<BitOrExpression>(std::make_shared<ShiftLeftExpression>(i_, integer_value(4)),
+                                          std::make_shared<BitAndExpression>(i_, integer_value(5))),
+        std::make_shared<BitXorExpression>(std::make_shared<ShiftRightExpression>(i_, integer_value(1)), integer_value(0xff)),
+        std::make_shared<GreaterExpression>(std::make_shared<MultiplyExpression>(x_, i_), number_value(2.5)),
+        std::make_shared<LessEqualExpression>(i_, x_),
+        std::make_shared<UnequalExpression>(std::make_shared<AddExpression>(i_, integer_value(1)), integer_value(4)),
+        std::make_shared<OrExpression>(std::make_shared<AndExpression>(b_, std::make_shared<LessExpression>(x_, number_value(1))),
+                                       std::make_shared<NotExpression>(std::make_shared<GreaterEqualExpression>(i_, integer_value(0)))),
+        std::make_shared<AddExpression>(std::make_shared<EqualExpression>(i_, integer_value(3)), x_),
+        std::make_shared<AndExpression>(b_, broken),
+        std::make_shared<OrExpression>(std::make_shared<NotExpression>(b_), broken),
+        std::make_shared<AddExpression>(std::make_shared<AndExpression>(b_, broken), integer_value(1)),
+    };
+}
+
+static std::string evaluate(const ConstExpression_ptr expression, const Type type) {
+    char buffer[64];
+    try {
+        switch (type) {
+        case boolean:
+            return expression->evaluate_boolean() ? "true" : "false";
+        case integer:
+            snprintf(buffer, sizeof(buffer), "%lld", (long long)expression->evaluate_integer());
+            return buffer;
+        default:
+            snprintf(buffer, sizeof(buffer), "%a", (double)expression->evaluate_number());
+            return buffer;
+        }
+    } catch (const std::runtime_error &e) {
+        return std::string("error: ") + e.what();
+    }
+}
+
+static void test_same_results() {
+    const std::vector<ConstExpression_ptr> expressions = create_expressions();
+    for (auto const &expression : expressions) {
+        const ConstExpression_ptr bytecode = BytecodeExpression::create(expression);
+        CHECK(std::dynamic_pointer_cast<const BytecodeExpression>(bytecode) != nullptr);
+        for (const int64_t i_value : {-9, -1, 1, 2, 3, 17}) {
+            for (const number_t x_value : {-2.75, 0.0, 0.5, 1.25, 1e3}) {
+                for (const bool b_value : {false, true}) {
+                    i->assign(std::make_shared<IntegerExpression>(i_value));
+                    x->assign(std::make_shared<NumberExpression>(x_value));
+                    b->assign(std::make_shared<BooleanExpression>(b_value));
+                    for (const Type type : {boolean, integer, number}) {
+                        if (type >= expression->type) {
+                            CHECK(evaluate(expression, type) == evaluate(bytecode, type));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void test_lazy_errors() {
+    const ConstExpression_ptr broken = std::make_shared<BrokenExpression>();
+    const ConstExpression_ptr expression = BytecodeExpression::create(
+        std::make_shared<AndExpression>(std::make_shared<VariableExpression>(b), broken));
+    b->assign(std::make_shared<BooleanExpression>(false));
+    CHECK(!expression->evaluate_boolean());
+    b->assign(std::make_shared<BooleanExpression>(true));
+    bool has_failed = false;
+    try {
+        expression->evaluate_boolean();
+    } catch (const std::runtime_error &e) {
+        has_failed = std::string(e.what()) == "not implemented";
+    }
+    CHECK(has_failed);
+}
+
+static void test_fallbacks() {
+    const ConstExpression_ptr literal = integer_value(1);
+    CHECK(BytecodeExpression::create(literal) == literal);
+    const ConstExpression_ptr variable = std::make_shared<VariableExpression>(x);
+    CHECK(BytecodeExpression::create(variable) == variable);
+    ConstExpression_ptr deep = integer_value(0);
+    for (int n = 0; n < BYTECODE_STACK_SIZE + 1; ++n) {
+        deep = std::make_shared<AddExpression>(integer_value(n), deep);
+    }
+    CHECK(BytecodeExpression::create(deep) == deep);
+}
+
+int main() {
+    test_same_results();
+    test_lazy_errors();
+    test_fallbacks();
+    return host_report();
+}
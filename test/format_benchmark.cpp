@@ -0,0 +1,20 @@
+#include "benchmark.h"
+#include "format.h"
+
+static char buffer[512];
+static volatile int length_sink;
+
+int main() {
+    const int count = 2000000;
+    volatile double value = 1234.56789;
+    volatile int64_t integer_value = -1234567890;
+    benchmark("sprintf(\"%.3f\")", count, [&]() { length_sink = sprintf(buffer, "%.3f", (double)value); });
+    benchmark("format_number(3)", count, [&]() { length_sink = format_number(buffer, value, 3); });
+    benchmark("sprintf(\"%.6f\")", count, [&]() { length_sink = sprintf(buffer, "%.6f", (double)value); });
+    benchmark("format_number(6)", count, [&]() { length_sink = format_number(buffer, value, 6); });
+    benchmark("sprintf(\"%lld\")", count, [&]() { length_sink = sprintf(buffer, "%lld", (long long)integer_value); });
+    benchmark("format_integer", count, [&]() { length_sink = format_integer(buffer, integer_value); });
+    benchmark("sprintf(\"%.17g\")", count, [&]() { length_sink = sprintf(buffer, "%.17g", (double)value); });
+    benchmark("format_number_shortest", count, [&]() { length_sink = format_number_shortest(buffer, value); });
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "format.h"
+#include "host.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+
+static bool is_printf_result(const double value, const unsigned int precision) {
+    char expected[512];
+    char buffer[512];
+    const int expected_length = snprintf(expected, sizeof(expected), "%.*f", precision, value);
+    const int length = format_number(buffer, value, precision);
+    if (length != expected_length || std::strcmp(buffer, expected) != 0) {
+        printf("%a with precision %u: \"%s\" instead of \"%s\"\n", value, precision, buffer, expected);
+        return false;
+    }
+    return true;
+}
+
+static void test_edge_cases() {
+    const double values[] = {
+        0.0, -0.0, 1.0, -1.0, 0.1, 0.7, 1e-9, 4e-10, 5e-10, 6e-10, 123456789.123456789, 8999999999.999999,
+        9e9, 9.2e18, 1e300, 5e-324, std::numeric_limits<double>::min(), std::numeric_limits<double>::max(),
+        std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), std::nan(""),
+    };
+    for (const double value : values) {
+        for (unsigned int precision = 0; precision <= 12; ++precision) {
+            CHECK(is_printf_result(value, precision));
+        }
+    }
+}
+
+static void test_ties() {
+    for (int k = -100; k <= 100; ++k) {
+        CHECK(is_printf_result(k + 0.5, 0));
+        CHECK(is_printf_result(k * 0.25 + 0.125, 2));
+        CHECK(is_printf_result(k / 1024.0, 9));
+    }
+}
+
+static void test_wide_products() {
+    std::mt19937_64 generator(1);
+    for (int n = 0; n < 200000; ++n) {
+        const uint64_t mantissa = (generator() >> 11) | (1ULL << 52);
+        const int exponent = (int)(generator() % 120) - 100;
+        const double value = std::ldexp((double)mantissa, exponent - 52);
+        const unsigned int precision = generator() % 10;
+        CHECK(is_printf_result(value, precision));
+        CHECK(is_printf_result(-value, precision));
+    }
+}
+
+static void test_random_bits() {
+    std::mt19937_64 generator(2);
+    for (int n = 0; n < 200000; ++n) {
+        const uint64_t bits = generator();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        CHECK(is_printf_result(value, generator() % 13));
+    }
+}
+
+static void test_integers() {
+    const int64_t values[] = {0, 1, -1, 9, 10, -10, 1234567890123, std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min()};
+    std::mt19937_64 generator(3);
+    for (int n = 0; n < 10000 + (int)(sizeof(values) / sizeof(values[0])); ++n) {
+        const int64_t value = n < (int)(sizeof(values) / sizeof(values[0])) ? values[n] : (int64_t)generator() >> (generator() % 64);
+        char expected[32];
+        char buffer[32];
+        const int expected_length = snprintf(expected, sizeof(expected), "%lld", (long long)value);
+        CHECK(format_integer(buffer, value) == expected_length && std::strcmp(buffer, expected) == 0);
+    }
+}
+
+static void test_shortest() {
+    const number_t values[] = {0, 1, -2, 0.1, 0.3, 1.0 / 3, 2.5e-7, 123456.789, 1e20, -1e-20};
+    std::mt19937_64 generator(4);
+    for (int n = 0; n < 100000; ++n) {
+        const number_t value = n < (int)(sizeof(values) / sizeof(values[0])) ? values[n] : (number_t)std::ldexp((double)generator() / 0x1p64, (int)(generator() % 80) - 40);
+        char buffer[64];
+        const int length = format_number_shortest(buffer, value);
+        CHECK(length == (int)std::strlen(buffer));
+        CHECK((number_t)strtod(buffer, nullptr) == value);
+        CHECK(std::strpbrk(buffer, ".e") != nullptr);
+    }
+    char buffer[64];
+    format_number_shortest(buffer, 0.1);
+    CHECK(std::strcmp(buffer, "0.1") == 0);
+    format_number_shortest(buffer, 100);
+    CHECK(std::strcmp(buffer, "100.0") == 0);
+}
+
+int main() {
+    test_edge_cases();
+    test_ties();
+    test_wide_products();
+    test_random_bits();
+    test_integers();
+    test_shortest();
+    return host_report();
+}
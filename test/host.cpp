@@ -0,0 +1,62 @@
+#include "host.h"
+#include "freertos/task.h"
+#include "uart.h"
+#include <cstdarg>
+#include <cstdio>
+
+int64_t host_time_us = 0;
+std::vector<std::string> host_output;
+
+static int failure_count = 0;
+
+int64_t esp_timer_get_time() {
+    return host_time_us;
+}
+
+void vTaskDelay(const TickType_t ticks) {
+    host_time_us += ticks * portTICK_PERIOD_MS * 1000;
+}
+
+static void record(const char *format, va_list args) {
+    char buffer[1024];
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    host_output.push_back(buffer);
+}
+
+void echo(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    record(format, args);
+    va_end(args);
+}
+
+void echo_telemetry(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    record(format, args);
+    va_end(args);
+}
+
+bool host_output_contains(const std::string &text) {
+    for (auto const &line : host_output) {
+        if (line.find(text) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void host_check(const bool condition, const char *expression, const char *file, const int line) {
+    if (!condition) {
+        printf("%s:%d: check failed: %s\n", file, line, expression);
+        failure_count++;
+    }
+}
+
+int host_report() {
+    if (failure_count > 0) {
+        printf("%d checks failed\n", failure_count);
+        return 1;
+    }
+    return 0;
+}
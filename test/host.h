@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+extern int64_t host_time_us;
+extern std::vector<std::string> host_output;
+
+bool host_output_contains(const std::string &text);
+
+#define CHECK(condition) host_check(condition, #condition, __FILE__, __LINE__)
+
+void host_check(const bool condition, const char *expression, const char *file, const int line);
+int host_report();
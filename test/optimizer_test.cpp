@@ -0,0 +1,44 @@
+#include "optimizer.h"
+#include "host.h"
+#include <cmath>
+
+static ConstExpression_ptr integer_value(const int64_t value) {
+    return std::make_shared<IntegerExpression>(value);
+}
+
+static bool is_integer_literal(const ConstExpression_ptr expression, const int64_t value) {
+    return std::dynamic_pointer_cast<const IntegerExpression>(expression) != nullptr &&
+           expression->evaluate_integer() == value &&
+           expression->evaluate_number() == (number_t)value;
+}
+
+static void test_negative_constants() {
+    CHECK(is_integer_literal(Optimizer::negate(integer_value(5)), -5));
+    CHECK(is_integer_literal(Optimizer::binary<SubtractExpression>(integer_value(2), integer_value(7)), -5));
+    CHECK(is_integer_literal(Optimizer::binary<AddExpression>(Optimizer::negate(integer_value(5)), integer_value(3)), -2));
+    CHECK(is_integer_literal(Optimizer::multiply(integer_value(-4), integer_value(3)), -12));
+}
+
+static void test_unfoldable_constants() {
+    // -0 is 0 as integer, but -0.0 as number
+    const ConstExpression_ptr negative_zero = Optimizer::negate(integer_value(0));
+    CHECK(std::dynamic_pointer_cast<const IntegerExpression>(negative_zero) == nullptr);
+    CHECK(std::signbit(negative_zero->evaluate_number()));
+
+    // -1 / 2 is 0 as integer, but -0.5 as number
+    const ConstExpression_ptr half = Optimizer::division<DivideExpression>(integer_value(-1), integer_value(2));
+    CHECK(std::dynamic_pointer_cast<const IntegerExpression>(half) == nullptr);
+    CHECK(half->evaluate_number() == (number_t)-0.5);
+
+    // -7 // 2 is -3 as integer, but -4 as number
+    const ConstExpression_ptr floor = Optimizer::division<FloorDivideExpression>(integer_value(-7), integer_value(2));
+    CHECK(std::dynamic_pointer_cast<const IntegerExpression>(floor) == nullptr);
+    CHECK(floor->evaluate_integer() == -3);
+    CHECK(floor->evaluate_number() == -4);
+}
+
+int main() {
+    test_negative_constants();
+    test_unfoldable_constants();
+    return host_report();
+}
@@ -0,0 +1,296 @@
+#include "can.h"
+#include "global.h"
+#include "host.h"
+#include "rmd_motor.h"
+#include "rmd_pair.h"
+#include <cstring>
+#include <deque>
+#include <set>
+
+// simulated TWAI driver: queued frames go on the bus when transfer() is called, RMD motors reply immediately
+static uint32_t driver_queue_length = 0;
+static twai_state_t driver_state = TWAI_STATE_RUNNING;
+static std::deque<twai_message_t> driver_queue;
+static std::deque<twai_message_t> received_frames;
+static std::vector<twai_message_t> bus_frames;
+static std::set<uint8_t> motor_ids;
+static std::set<std::pair<uint8_t, uint8_t>> ignored_requests;
+
+esp_err_t twai_driver_install(const twai_general_config_t *g_config, const twai_timing_config_t *, const twai_filter_config_t *) {
+    driver_queue_length = g_config->tx_queue_len;
+    return ESP_OK;
+}
+
+esp_err_t twai_driver_uninstall() {
+    return ESP_OK;
+}
+
+esp_err_t twai_start() {
+    return ESP_OK;
+}
+
+esp_err_t twai_stop() {
+    return ESP_OK;
+}
+
+esp_err_t twai_initiate_recovery() {
+    return ESP_OK;
+}
+
+esp_err_t twai_transmit(const twai_message_t *message, TickType_t) {
+    if (driver_state != TWAI_STATE_RUNNING) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (driver_queue.size() >= driver_queue_length) {
+        return ESP_ERR_TIMEOUT;
+    }
+    driver_queue.push_back(*message);
+    return ESP_OK;
+}
+
+esp_err_t twai_receive(twai_message_t *message, TickType_t) {
+    if (received_frames.empty()) {
+        return ESP_ERR_TIMEOUT;
+    }
+    *message = received_frames.front();
+    received_frames.pop_front();
+    return ESP_OK;
+}
+
+esp_err_t twai_get_status_info(twai_status_info_t *status_info) {
+    *status_info = {};
+    status_info->state = driver_state;
+    status_info->msgs_to_tx = driver_queue.size();
+    return ESP_OK;
+}
+
+static void reply(const uint8_t motor_id, const twai_message_t &request) {
+    if (ignored_requests.count({motor_id, request.data[0]})) {
+        return;
+    }
+    twai_message_t message = request;
+    message.identifier = 0x240 + motor_id;
+    received_frames.push_back(message);
+}
+
+static void transfer() {
+    for (auto const &message : driver_queue) {
+        bus_frames.push_back(message);
+        for (const uint8_t motor_id : motor_ids) {
+            if (message.identifier == 0x140 + motor_id || message.identifier == 0x280) {
+                reply(motor_id, message);
+            }
+        }
+    }
+    driver_queue.clear();
+}
+
+static int count_frames(const uint32_t id, const uint8_t command) {
+    int count = 0;
+    for (auto const &message : bus_frames) {
+        count += message.identifier == id && message.data[0] == command;
+    }
+    return count;
+}
+
+static Can_ptr setup(const int motor_count) {
+    Global::modules.clear();
+    Global::variables.clear();
+    driver_queue.clear();
+    received_frames.clear();
+    bus_frames.clear();
+    motor_ids.clear();
+    ignored_requests.clear();
+    driver_state = TWAI_STATE_RUNNING;
+    host_output.clear();
+    const Can_ptr can = std::make_shared<Can>("can", GPIO_NUM_0, GPIO_NUM_0, 1000000);
+    Global::add_module("can", can);
+    for (uint8_t motor_id = 1; motor_id <= motor_count; ++motor_id) {
+        const RmdMotor_ptr motor = std::make_shared<RmdMotor>("rmd" + std::to_string(motor_id), can, motor_id, 6);
+        motor->subscribe_to_can();
+        Global::add_module(motor->name, motor);
+        motor_ids.insert(motor_id);
+    }
+    return can;
+}
+
+static RmdMotor_ptr get_motor(const uint8_t motor_id) {
+    return std::static_pointer_cast<RmdMotor>(Global::get_module("rmd" + std::to_string(motor_id)));
+}
+
+static void run_cycles(const int count) {
+    for (int i = 0; i < count; ++i) {
+        for (auto const &item : Global::modules) {
+            item.second->step();
+        }
+        transfer();
+        host_time_us += 10000;
+    }
+}
+
+static void test_pipelined_requests() {
+    setup(4);
+    for (auto const &item : Global::modules) {
+        item.second->step();
+    }
+    CHECK(driver_queue.size() == 8);
+    transfer();
+    run_cycles(10);
+    for (uint32_t id = 0x141; id <= 0x144; ++id) {
+        CHECK(count_frames(id, 0x92) == 1);
+        CHECK(count_frames(id, 0x9c) == 11);
+    }
+    CHECK(!host_output_contains("warning"));
+}
+
+static void test_setpoint_replacement() {
+    const Can_ptr can = setup(1);
+    const RmdMotor_ptr motor = get_motor(1);
+    run_cycles(1);
+    ignored_requests.insert({1, 0x43});
+    motor->set_acceleration(0, 1000);
+    motor->speed(1);
+    motor->speed(2);
+    motor->speed(3);
+    CHECK(motor->is_requested(0xa2));
+    transfer();
+    ignored_requests.clear();
+    run_cycles(4);
+    CHECK(count_frames(0x141, 0x43) == 2);
+    CHECK(count_frames(0x141, 0xa2) == 1);
+    int32_t speed = 0;
+    for (auto const &message : bus_frames) {
+        if (message.data[0] == 0xa2) {
+            std::memcpy(&speed, message.data + 4, 4);
+        }
+    }
+    CHECK(speed == 300);
+
+    for (int i = 0; i < 20; ++i) {
+        can->send(0x300, 0, 0, 0, 0, 0, 0, 0, 0);
+    }
+    can->send(0x301, 1, 0, 0, 0, 0, 0, 0, 0, false, can_tx_setpoint);
+    can->send(0x301, 2, 0, 0, 0, 0, 0, 0, 0, false, can_tx_setpoint);
+    can->step();
+    CHECK(can->get_property("tx_coalesced")->integer_value == 1);
+    while (!driver_queue.empty()) {
+        transfer();
+        can->step();
+    }
+    CHECK(count_frames(0x301, 1) == 0);
+    CHECK(count_frames(0x301, 2) == 1);
+    CHECK(bus_frames.back().identifier == 0x300);
+}
+
+static void test_retries() {
+    setup(1);
+    ignored_requests.insert({1, 0x9c});
+    run_cycles(4);
+    CHECK(count_frames(0x141, 0x9c) == 4);
+    CHECK(host_output_contains("rmd1 warning: CAN timeout for msg id 0x9c (attempt 1/3)"));
+    CHECK(host_output_contains("rmd1 warning: CAN timeout for msg id 0x9c (attempt 3/3)"));
+    CHECK(!host_output_contains("msg id 0x92"));
+}
+
+static void test_stop_discards_requests() {
+    setup(1);
+    const RmdMotor_ptr motor = get_motor(1);
+    run_cycles(1);
+    ignored_requests.insert({1, 0x43});
+    motor->set_acceleration(0, 1000);
+    motor->speed(10);
+    motor->stop();
+    run_cycles(5);
+    CHECK(count_frames(0x141, 0x43) == 1);
+    CHECK(count_frames(0x141, 0xa2) == 0);
+    CHECK(count_frames(0x141, 0x81) == 1);
+}
+
+static void test_stopped_driver() {
+    const Can_ptr can = setup(1);
+    const RmdMotor_ptr motor = get_motor(1);
+    CHECK(driver_queue_length == 16);
+    run_cycles(1);
+    driver_state = TWAI_STATE_BUS_OFF;
+    motor->speed(10);
+    can->send(0x141, 0x81, 0, 0, 0, 0, 0, 0, 0, false, can_tx_emergency);
+    can->step();
+    CHECK(can->get_property("tx_dropped")->integer_value == 1);
+    driver_state = TWAI_STATE_RUNNING;
+    can->step();
+    transfer();
+    CHECK(count_frames(0x141, 0xa2) == 0);
+    CHECK(count_frames(0x141, 0x81) == 1);
+
+    std::make_shared<Can>("slow_can", GPIO_NUM_0, GPIO_NUM_0, 125000);
+    CHECK(driver_queue_length == 9);
+}
+
+static std::vector<uint32_t> bus_ids() {
+    std::vector<uint32_t> ids;
+    for (auto const &message : bus_frames) {
+        ids.push_back(message.identifier);
+    }
+    return ids;
+}
+
+static void test_transmit_order() {
+    const Can_ptr can = setup(0);
+    const uint8_t data[8] = {};
+    driver_queue.resize(driver_queue_length);
+    can->send(0x20d, data, false, 8, can_tx_setpoint, 0x20);
+    can->send(0x20b, data, false, 8, can_tx_config, 0x20);
+    can->send(0x20d, data, false, 8, can_tx_setpoint, 0x20);
+    can->send(0x20d, data, false, 8, can_tx_setpoint, 0x20);
+    can->send(0x40d, data, false, 8, can_tx_setpoint, 0x40);
+    can->send(0x80, data, false, 1, can_tx_sync);
+    can->send(0x80, data, false, 1, can_tx_sync);
+    driver_queue.clear();
+    can->step();
+    transfer();
+    CHECK((bus_ids() == std::vector<uint32_t>{0x80, 0x80, 0x20d, 0x40d, 0x20b, 0x20d}));
+    CHECK(can->get_property("tx_coalesced")->integer_value == 1);
+}
+
+static void test_extended_frames() {
+    const Can_ptr can = setup(1);
+    twai_message_t message = {};
+    message.identifier = 0x241;
+    message.flags = TWAI_MSG_FLAG_EXTD;
+    received_frames.push_back(message);
+    can->step();
+    CHECK(can->get_property("rx_dispatched")->integer_value == 0);
+    CHECK(can->get_property("rx_unsubscribed")->integer_value == 1);
+    message.flags = TWAI_MSG_FLAG_NONE;
+    received_frames.push_back(message);
+    can->step();
+    CHECK(can->get_property("rx_dispatched")->integer_value == 1);
+}
+
+static void test_pair_abort() {
+    setup(2);
+    const std::shared_ptr<RmdPair> pair = std::make_shared<RmdPair>("pair", get_motor(1), get_motor(2));
+    Global::add_module("pair", pair);
+    run_cycles(1);
+    ignored_requests.insert({2, 0x43});
+    const unsigned int method_id = pair->find_method("move", {std::make_shared<NumberExpression>(90), std::make_shared<NumberExpression>(90)});
+    pair->call(method_id, {std::make_shared<NumberExpression>(90), std::make_shared<NumberExpression>(90)});
+    run_cycles(10);
+    CHECK(count_frames(0x141, 0xa4) == 1);
+    CHECK(count_frames(0x142, 0x43) == 3);
+    CHECK(count_frames(0x142, 0xa4) == 0);
+    CHECK(count_frames(0x280, 0x81) == 1);
+    CHECK(host_output_contains("error: could not move RMD motor pair"));
+}
+
+int main() {
+    test_pipelined_requests();
+    test_setpoint_replacement();
+    test_retries();
+    test_stop_discards_requests();
+    test_stopped_driver();
+    test_transmit_order();
+    test_extended_frames();
+    test_pair_abort();
+    return host_report();
+}
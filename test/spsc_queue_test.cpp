@@ -0,0 +1,70 @@
+#include "host.h"
+#include "spsc_queue.h"
+#include <string>
+#include <thread>
+
+static void test_full_and_empty() {
+    SpscQueue<int> queue(3);
+    int item = 0;
+    CHECK(queue.empty());
+    CHECK(!queue.pop(item));
+    CHECK(queue.push(1));
+    CHECK(queue.push(2));
+    CHECK(queue.push(3));
+    CHECK(!queue.push(4));
+    CHECK(queue.pop(item) && item == 1);
+    CHECK(queue.push(4));
+    CHECK(queue.pop(item) && item == 2);
+    CHECK(queue.pop(item) && item == 3);
+    CHECK(queue.pop(item) && item == 4);
+    CHECK(!queue.pop(item));
+    CHECK(queue.empty());
+}
+
+static void test_wrap_around() {
+    SpscQueue<int> queue(4);
+    int item = 0;
+    bool is_in_order = true;
+    for (int n = 0; n < 100; ++n) {
+        is_in_order &= queue.push(2 * n) && queue.push(2 * n + 1);
+        is_in_order &= queue.pop(item) && item == 2 * n;
+        is_in_order &= queue.pop(item) && item == 2 * n + 1;
+    }
+    CHECK(is_in_order);
+    CHECK(queue.empty());
+}
+
+static void test_threads() {
+    // a producer and a consumer thread stand in for two FreeRTOS tasks on different cores
+    const int count = 200000;
+    SpscQueue<std::string> queue(16);
+    std::thread producer([&]() {
+        for (int n = 0; n < count; ++n) {
+            const std::string line = "line " + std::to_string(n) + std::string(n % 50, 'x');
+            while (!queue.push(line)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    int received_count = 0;
+    bool is_in_order = true;
+    std::string line;
+    while (received_count < count) {
+        if (queue.pop(line)) {
+            is_in_order &= line == "line " + std::to_string(received_count) + std::string(received_count % 50, 'x');
+            received_count++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    CHECK(is_in_order);
+    CHECK(queue.empty());
+}
+
+int main() {
+    test_full_and_empty();
+    test_wrap_around();
+    test_threads();
+    return host_report();
+}
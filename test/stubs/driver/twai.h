@@ -0,0 +1,83 @@
+#pragma once
+
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include <stdint.h>
+
+#define TWAI_STD_ID_MASK 0x7FF
+#define TWAI_MSG_FLAG_NONE 0x00
+#define TWAI_MSG_FLAG_EXTD 0x01
+#define TWAI_MSG_FLAG_RTR 0x02
+
+typedef enum {
+    TWAI_MODE_NORMAL,
+    TWAI_MODE_NO_ACK,
+    TWAI_MODE_LISTEN_ONLY,
+} twai_mode_t;
+
+typedef enum {
+    TWAI_STATE_STOPPED,
+    TWAI_STATE_RUNNING,
+    TWAI_STATE_BUS_OFF,
+    TWAI_STATE_RECOVERING,
+} twai_state_t;
+
+typedef struct {
+    uint32_t flags;
+    uint32_t identifier;
+    uint8_t data_length_code;
+    uint8_t data[8];
+} twai_message_t;
+
+typedef struct {
+    twai_mode_t mode;
+    gpio_num_t tx_io;
+    gpio_num_t rx_io;
+    uint32_t tx_queue_len;
+    uint32_t rx_queue_len;
+} twai_general_config_t;
+
+typedef struct {
+    uint32_t brp;
+} twai_timing_config_t;
+
+typedef struct {
+    uint32_t acceptance_code;
+    uint32_t acceptance_mask;
+    bool single_filter;
+} twai_filter_config_t;
+
+typedef struct {
+    twai_state_t state;
+    uint32_t msgs_to_tx;
+    uint32_t msgs_to_rx;
+    uint32_t tx_error_counter;
+    uint32_t rx_error_counter;
+    uint32_t tx_failed_count;
+    uint32_t rx_missed_count;
+    uint32_t rx_overrun_count;
+    uint32_t arb_lost_count;
+    uint32_t bus_error_count;
+} twai_status_info_t;
+
+#define TWAI_GENERAL_CONFIG_DEFAULT(tx_io_num, rx_io_num, op_mode) \
+    { op_mode, tx_io_num, rx_io_num, 5, 5 }
+#define TWAI_TIMING_CONFIG_25KBITS() {128}
+#define TWAI_TIMING_CONFIG_50KBITS() {80}
+#define TWAI_TIMING_CONFIG_100KBITS() {40}
+#define TWAI_TIMING_CONFIG_125KBITS() {32}
+#define TWAI_TIMING_CONFIG_250KBITS() {16}
+#define TWAI_TIMING_CONFIG_500KBITS() {8}
+#define TWAI_TIMING_CONFIG_800KBITS() {4}
+#define TWAI_TIMING_CONFIG_1MBITS() {4}
+#define TWAI_FILTER_CONFIG_ACCEPT_ALL() {0, 0xFFFFFFFF, true}
+
+esp_err_t twai_driver_install(const twai_general_config_t *g_config, const twai_timing_config_t *t_config,
+                              const twai_filter_config_t *f_config);
+esp_err_t twai_driver_uninstall();
+esp_err_t twai_start();
+esp_err_t twai_stop();
+esp_err_t twai_initiate_recovery();
+esp_err_t twai_transmit(const twai_message_t *message, TickType_t ticks_to_wait);
+esp_err_t twai_receive(twai_message_t *message, TickType_t ticks_to_wait);
+esp_err_t twai_get_status_info(twai_status_info_t *status_info);
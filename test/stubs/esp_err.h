@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdexcept>
+
+typedef int esp_err_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_STATE 0x103
+#define ESP_ERR_TIMEOUT 0x107
+
+#define ESP_ERROR_CHECK(x)                                 \
+    do {                                                   \
+        if ((x) != ESP_OK) {                               \
+            throw std::runtime_error("ESP_ERROR_CHECK"); \
+        }                                                  \
+    } while (0)
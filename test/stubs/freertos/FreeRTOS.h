@@ -0,0 +1,16 @@
+#pragma once
+
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define IRAM_ATTR
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+void vTaskDelay(const TickType_t ticks);
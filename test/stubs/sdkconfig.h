@@ -0,0 +1,5 @@
+#pragma once
+
+#define CONFIG_LIZARD_BAUD_RATE 115200
+#define CONFIG_LIZARD_CAN_RX_QUEUE_LENGTH 20
+#define CONFIG_LIZARD_CAN_RX_RING_DEPTH 64